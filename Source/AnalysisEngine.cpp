@@ -0,0 +1,208 @@
+#include "AnalysisEngine.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr float epsilon = 1.0e-6f;
+    constexpr float minFrequency = 20.0f;
+    constexpr float maxFrequency = 20000.0f;
+
+    // Band energy, after the 1 / fftSize scaling, below which a band's stereo
+    // image reads as silent: about -100 dB.
+    constexpr double silentEnergy = 1.0e-10;
+}
+
+float AnalysisEngine::MeterAccumulator::getCorrelation() const noexcept
+{
+    const double denom = std::sqrt (juce::jmax (static_cast<double> (epsilon), sumLeft * sumRight));
+    const float correlation = denom > 0.0 ? static_cast<float> (sumLR / denom) : 0.0f;
+    return juce::jlimit (-1.0f, 1.0f, correlation);
+}
+
+float AnalysisEngine::MeterAccumulator::getWidth() const noexcept
+{
+    return sumMid > 0.0 ? juce::jlimit (0.0f, 1.0f, static_cast<float> (sumSide / sumMid)) : 0.0f;
+}
+
+float AnalysisEngine::toDisplayLevel (float magnitude) noexcept
+{
+    const float dbValue = juce::Decibels::gainToDecibels (magnitude + epsilon, -120.0f);
+    return juce::jlimit (0.0f, 1.0f, juce::jmap (dbValue, spectrumFloorDb, spectrumCeilingDb, 0.0f, 1.0f));
+}
+
+// Log-spaced bands from 20 Hz to 20 kHz; the bin edges only depend on the rate.
+juce::Range<int> AnalysisEngine::getBandBins (int band, double sampleRate, int bandCount) noexcept
+{
+    const float lowFreq = minFrequency * std::pow (maxFrequency / minFrequency, static_cast<float> (band) / bandCount);
+    const float highFreq = minFrequency * std::pow (maxFrequency / minFrequency, static_cast<float> (band + 1) / bandCount);
+    const int lowBin = juce::jmax (1, static_cast<int> (lowFreq * fftSize / sampleRate));
+    const int highBin = juce::jmin (fftSize / 2, static_cast<int> (highFreq * fftSize / sampleRate));
+
+    return { lowBin, juce::jmax (lowBin, highBin) };
+}
+
+// The normalised Hann window's spectrum, at d bins from a sine, is
+// sinc (d) / (1 - d^2), and PairedFft's scaling halves it: 0.5 on the sine's
+// bin, 0.25 one bin away, 0 further out.
+float AnalysisEngine::getSineBandMagnitude (juce::Range<int> bins, double frequency, double sampleRate) noexcept
+{
+    if (bins.isEmpty())
+        return 0.0f;
+
+    const double sineBin = frequency * fftSize / sampleRate;
+    double sum = 0.0;
+
+    for (int bin = bins.getStart(); bin < bins.getEnd(); ++bin)
+    {
+        const double d = bin - sineBin;
+
+        if (std::abs (d) < 1.0e-6)
+            sum += 0.5;
+        else if (std::abs (std::abs (d) - 1.0) < 1.0e-6)
+            sum += 0.25;
+        else
+            sum += 0.5 * std::abs (std::sin (juce::MathConstants<double>::pi * d)
+                                   / (juce::MathConstants<double>::pi * d * (1.0 - d * d)));
+    }
+
+    return (float) (sum / bins.getLength());
+}
+
+void AnalysisEngine::prepare (double sampleRate)
+{
+    frames.prepare();
+    spectrum.sampleRate = sampleRate;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const auto bins = getBandBins (band, sampleRate);
+        bandLowBins[(size_t) band] = bins.getStart();
+        bandHighBins[(size_t) band] = bins.getEnd();
+    }
+
+    // The bands are contiguous, so each bin belongs to at most one.
+    binBands.fill (-1);
+
+    for (int band = 0; band < numBands; ++band)
+        for (int bin = bandLowBins[(size_t) band]; bin < bandHighBins[(size_t) band]; ++bin)
+            binBands[(size_t) bin] = band;
+
+    // Spectrogram rows: at the low end several rows share one bin.
+    for (int row = 0; row < numSpectrumRows; ++row)
+    {
+        const float lowFreq = minFrequency * std::pow (maxFrequency / minFrequency, static_cast<float> (row) / numSpectrumRows);
+        const float highFreq = minFrequency * std::pow (maxFrequency / minFrequency, static_cast<float> (row + 1) / numSpectrumRows);
+        const int lowBin = juce::jlimit (1, fftSize / 2 - 1, static_cast<int> (lowFreq * fftSize / sampleRate));
+
+        rowLowBins[(size_t) row] = lowBin;
+        rowHighBins[(size_t) row] = juce::jlimit (lowBin + 1, fftSize / 2, static_cast<int> (highFreq * fftSize / sampleRate));
+    }
+
+    reset();
+}
+
+void AnalysisEngine::reset() noexcept
+{
+    frames.reset();
+    bands.fill (0.0f);
+    column.fill (0);
+    spectrum.magnitudes.fill (0.0f);
+    stereoBands = {};
+    meters = {};
+}
+
+void AnalysisEngine::accumulateMeters (const float* left, const float* right, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float L = left != nullptr ? left[i] : 0.0f;
+        const float R = right != nullptr ? right[i] : L;
+
+        meters.peakLeft = juce::jmax (meters.peakLeft, std::abs (L));
+        meters.peakRight = juce::jmax (meters.peakRight, std::abs (R));
+
+        meters.sumLeft += static_cast<double> (L) * L;
+        meters.sumRight += static_cast<double> (R) * R;
+        meters.sumLR += static_cast<double> (L) * R;
+
+        const float mid = 0.5f * (L + R);
+        const float side = 0.5f * (L - R);
+        meters.sumMid += static_cast<double> (mid) * mid;
+        meters.sumSide += static_cast<double> (side) * side;
+    }
+
+    meters.samples += numSamples;
+}
+
+// Both channels come out of one complex FFT; see PairedFft. The mono spectrum
+// is (L + R) / 2 as before, and the same pass over the bins sums each band's
+// cross-spectrum, so the stereo image costs that pass rather than two more
+// transforms.
+const AnalysisEngine::Bands& AnalysisEngine::computeBands() noexcept
+{
+    NEONSCOPE_TRACE_SCOPE ("Analysis bands");
+
+    struct BandSums
+    {
+        double left = 0.0, right = 0.0, cross = 0.0, mid = 0.0, side = 0.0;
+    };
+
+    std::array<BandSums, numBands> sums {};
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const auto leftBin = frames.first (bin);
+        const auto rightBin = frames.second (bin);
+        const auto mid = (leftBin + rightBin) * 0.5f;
+
+        spectrum.magnitudes[(size_t) bin] = std::abs (mid);
+
+        if (const int band = binBands[(size_t) bin]; band >= 0)
+        {
+            const auto side = (leftBin - rightBin) * 0.5f;
+            auto& sum = sums[(size_t) band];
+            sum.left += std::norm (leftBin);
+            sum.right += std::norm (rightBin);
+            sum.cross += (double) (leftBin * std::conj (rightBin)).real();
+            sum.mid += std::norm (mid);
+            sum.side += std::norm (side);
+        }
+    }
+
+    const auto* magnitudes = spectrum.magnitudes.data();
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const int lowBin = bandLowBins[(size_t) band];
+        const int highBin = bandHighBins[(size_t) band];
+
+        float sum = 0.0f;
+        for (int bin = lowBin; bin < highBin; ++bin)
+            sum += magnitudes[bin];
+
+        const int count = highBin - lowBin;
+        bands[(size_t) band] = toDisplayLevel (count > 0 ? sum / count : 0.0f);
+
+        const auto& stereo = sums[(size_t) band];
+        const double energy = stereo.left + stereo.right;
+        const bool silent = energy < silentEnergy;
+        stereoBands.correlation[(size_t) band] = silent ? 0.0f : juce::jlimit (-1.0f, 1.0f, (float) (stereo.cross / std::sqrt (juce::jmax (stereo.left * stereo.right, silentEnergy * silentEnergy))));
+        stereoBands.width[(size_t) band] = silent ? 0.0f : juce::jlimit (0.0f, 1.0f, (float) (stereo.side / juce::jmax (stereo.mid, silentEnergy)));
+        stereoBands.balance[(size_t) band] = silent ? 0.0f : (float) ((stereo.right - stereo.left) / energy);
+    }
+
+    for (int row = 0; row < numSpectrumRows; ++row)
+    {
+        const float magnitude = *std::max_element (magnitudes + rowLowBins[(size_t) row], magnitudes + rowHighBins[(size_t) row]);
+        column[(size_t) row] = static_cast<juce::uint8> (juce::roundToInt (toDisplayLevel (magnitude) * 255.0f));
+    }
+
+    return bands;
+}
+
+size_t AnalysisEngine::getMemoryBytes() const noexcept
+{
+    return frames.getMemoryBytes();
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PairedFft.h"
+#include <array>
+#include <cmath>
+
+// The metering and spectrum analysis behind the meters and band display,
+// shared by the processor and the offline analyser. It only measures: the
+// display ballistics and smoothing stay with whoever publishes the results.
+class AnalysisEngine
+{
+public:
+    static constexpr int numBands = 16;
+    static constexpr int fftOrder = PairedFft::order;
+    static constexpr int fftSize = PairedFft::size;
+    static constexpr int numBins = PairedFft::numBins;
+
+    // Display range for the band levels and spectrogram rows.
+    static constexpr float spectrumFloorDb = -80.0f;
+    static constexpr float spectrumCeilingDb = -10.0f;
+
+    // A magnitude mapped to 0..1 by its dB value over the display range.
+    // Every band display goes through this, so they all line up.
+    static float toDisplayLevel (float magnitude) noexcept;
+
+    // Output statistics gathered since the last resetMeters().
+    struct MeterAccumulator
+    {
+        float peakLeft = 0.0f;
+        float peakRight = 0.0f;
+        double sumLeft = 0.0;
+        double sumRight = 0.0;
+        double sumLR = 0.0;
+        double sumMid = 0.0;
+        double sumSide = 0.0;
+        int samples = 0;
+
+        float getRmsLeft() const noexcept   { return samples > 0 ? (float) std::sqrt (sumLeft / samples) : 0.0f; }
+        float getRmsRight() const noexcept  { return samples > 0 ? (float) std::sqrt (sumRight / samples) : 0.0f; }
+        float getCorrelation() const noexcept;
+        float getWidth() const noexcept;
+    };
+
+    using Bands = std::array<float, numBands>;
+
+    // Stereo image per band, from the cross-spectrum of the same frame:
+    // correlation from -1 to 1, width as side over mid energy from 0 to 1,
+    // and balance from -1 (left only) to 1 (right only). Silent bands read 0.
+    struct StereoBands
+    {
+        Bands correlation {}, width {}, balance {};
+    };
+
+    // The same frame at spectrogram resolution: log-spaced rows from 20 Hz to
+    // 20 kHz, lowest first, each the loudest bin in its range scaled to 0..255
+    // over the display range.
+    static constexpr int numSpectrumRows = 256;
+    using SpectrumColumn = std::array<juce::uint8, numSpectrumRows>;
+
+    // And at full resolution: every bin's magnitude, scaled by 1 / fftSize.
+    struct Spectrum
+    {
+        double sampleRate = 44100.0;
+        std::array<float, numBins> magnitudes {};
+    };
+
+    // The FFT bins [start, end) summed into a band at this rate, for the
+    // display's bands or the same 20 Hz to 20 kHz range split bandCount ways.
+    // Low bands can be empty at low rates.
+    static juce::Range<int> getBandBins (int band, double sampleRate, int bandCount = numBands) noexcept;
+
+    // The magnitude a band over these bins reads for a sine of amplitude 1 at
+    // this frequency, before toDisplayLevel: PairedFft's window and scaling,
+    // averaged over the band.
+    static float getSineBandMagnitude (juce::Range<int> bins, double frequency, double sampleRate) noexcept;
+
+    // Allocates on the first call only; later calls just recompute the band
+    // bin ranges and reset.
+    void prepare (double sampleRate);
+    void reset() noexcept;
+
+    // right may be null for mono input.
+    void accumulateMeters (const float* left, const float* right, int numSamples) noexcept;
+    const MeterAccumulator& getMeters() const noexcept  { return meters; }
+    void resetMeters() noexcept                          { meters = {}; }
+
+    // Feeds both channels into the analysis FIFOs. Every time they fill, the
+    // frame is transformed and onFrame is called with each band's level of
+    // the mono mix, normalised to 0..1 over the display range;
+    // getSpectrumColumn(), getSpectrum() and getStereoBands() then hold the
+    // same frame.
+    template <typename FrameCallback>
+    void pushSpectrum (const float* left, const float* right, int numSamples, FrameCallback&& onFrame)
+    {
+        frames.push (left, nullptr, right != nullptr ? right : left, nullptr, numSamples,
+                     [this, &onFrame] { onFrame (computeBands()); });
+    }
+
+    const SpectrumColumn& getSpectrumColumn() const noexcept  { return column; }
+    const Spectrum& getSpectrum() const noexcept              { return spectrum; }
+    const StereoBands& getStereoBands() const noexcept        { return stereoBands; }
+
+    size_t getMemoryBytes() const noexcept;
+
+private:
+    const Bands& computeBands() noexcept;
+
+    PairedFft frames;    // left as the first signal, right as the second
+    std::array<int, numBands> bandLowBins {};
+    std::array<int, numBands> bandHighBins {};
+    std::array<int, numBins> binBands {};    // band of each bin, or -1
+    std::array<int, numSpectrumRows> rowLowBins {};
+    std::array<int, numSpectrumRows> rowHighBins {};
+    Bands bands {};
+    SpectrumColumn column {};
+    Spectrum spectrum;
+    StereoBands stereoBands;
+    MeterAccumulator meters;
+};
@@ -0,0 +1,136 @@
+#include "BandFilterbank.h"
+#include "AnalysisEngine.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr double minFrequency = 20.0;
+    constexpr double maxFrequency = 20000.0;
+
+    // Fall time of the envelope to 1/e; fast enough to show a kick's decay.
+    constexpr double releaseSeconds = 0.08;
+}
+
+void BandFilterbank::prepare (double sampleRate, int newNumBands)
+{
+    numBands = juce::jlimit (1, maxBands, newNumBands);
+    groups.assign ((size_t) ((numBands + (int) Vec::SIMDNumElements - 1) / (int) Vec::SIMDNumElements), {});
+    mono.resize ((size_t) maxChunk);
+
+    const double octavesPerBand = std::log2 (maxFrequency / minFrequency) / numBands;
+    const double q = std::sqrt (std::exp2 (octavesPerBand)) / (std::exp2 (octavesPerBand) - 1.0);
+    const double nyquistLimit = sampleRate * 0.45;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        // RBJ constant-peak band-pass at the geometric centre of the band.
+        // Bands above the usable range are left silent.
+        const double centre = minFrequency * std::exp2 (octavesPerBand * (band + 0.5));
+        auto& group = groups[(size_t) band / Vec::SIMDNumElements];
+        const auto lane = (size_t) band % Vec::SIMDNumElements;
+
+        // A sine at the centre peaks at its amplitude here. The FFT bands read
+        // it through the window's main lobe averaged over the band's bins, so
+        // it is scaled by what they would show. A band too narrow to own a bin
+        // takes the bin nearest its centre.
+        auto bins = AnalysisEngine::getBandBins (band, sampleRate, numBands);
+
+        if (bins.isEmpty())
+            bins = juce::Range<int>::withStartAndLength (juce::jmax (1, juce::roundToInt (centre * AnalysisEngine::fftSize / sampleRate)), 1);
+
+        levelScales[(size_t) band] = AnalysisEngine::getSineBandMagnitude (bins, centre, sampleRate);
+
+        if (centre >= nyquistLimit)
+            continue;
+
+        const double w0 = juce::MathConstants<double>::twoPi * centre / sampleRate;
+        const double alpha = std::sin (w0) / (2.0 * q);
+        const double a0 = 1.0 + alpha;
+
+        group.b0.set (lane, (float) (alpha / a0));
+        group.negA1.set (lane, (float) (2.0 * std::cos (w0) / a0));
+        group.negA2.set (lane, (float) (-(1.0 - alpha) / a0));
+    }
+
+    release = Vec::expand ((float) std::exp (-1.0 / (releaseSeconds * sampleRate)));
+    reset();
+}
+
+void BandFilterbank::reset() noexcept
+{
+    const auto zero = Vec::expand (0.0f);
+
+    for (auto& group : groups)
+    {
+        group.s1 = zero;
+        group.s2 = zero;
+        group.envelope = zero;
+    }
+}
+
+// Transposed direct form II, with the envelope taking the larger of the
+// rectified output and its own decayed value.
+void BandFilterbank::process (const float* left, const float* right, int numSamples) noexcept
+{
+    for (int offset = 0; offset < numSamples; offset += maxChunk)
+    {
+        const int count = juce::jmin (maxChunk, numSamples - offset);
+        auto* samples = mono.data();
+
+        if (right != nullptr)
+        {
+            juce::FloatVectorOperations::add (samples, left + offset, right + offset, count);
+            juce::FloatVectorOperations::multiply (samples, 0.5f, count);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copy (samples, left + offset, count);
+        }
+
+        const auto zero = Vec::expand (0.0f);
+
+        for (auto& group : groups)
+        {
+            auto s1 = group.s1, s2 = group.s2, envelope = group.envelope;
+            const auto b0 = group.b0, negA1 = group.negA1, negA2 = group.negA2;
+
+            for (int i = 0; i < count; ++i)
+            {
+                const auto x = Vec::expand (samples[i]);
+                const auto y = Vec::multiplyAdd (s1, b0, x);
+                s1 = Vec::multiplyAdd (s2, negA1, y);
+                s2 = Vec::multiplyAdd (negA2 * y, b0, zero - x);
+                envelope = Vec::max (envelope * release, Vec::max (y, zero - y));
+            }
+
+            group.s1 = s1;
+            group.s2 = s2;
+            group.envelope = envelope;
+        }
+    }
+
+    // A NaN in the input would stay in the filter state for good.
+    for (const auto& group : groups)
+    {
+        if (! std::isfinite (group.envelope.sum() + group.s1.sum() + group.s2.sum()))
+        {
+            reset();
+            break;
+        }
+    }
+}
+
+void BandFilterbank::getLevels (float* destination) const noexcept
+{
+    for (int band = 0; band < numBands; ++band)
+    {
+        const float envelope = groups[(size_t) band / Vec::SIMDNumElements].envelope.get ((size_t) band % Vec::SIMDNumElements);
+        destination[band] = AnalysisEngine::toDisplayLevel (envelope * levelScales[(size_t) band]);
+    }
+}
+
+size_t BandFilterbank::getMemoryBytes() const noexcept
+{
+    return groups.capacity() * sizeof (Group) + mono.capacity() * sizeof (float);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// Band levels from a bank of band-pass biquads, as a low-latency alternative
+// to the analysis FFT. Bands are log-spaced from 20 Hz to 20 kHz like
+// AnalysisEngine's, one biquad at each band centre with a Q that spans the
+// band, followed by a peak envelope with instant attack.
+//
+// Bands are processed a SIMD register at a time (four per register with SSE
+// and NEON), each group's filter and envelope state held in registers across
+// a whole chunk of samples. The cost per sample is fixed and grows with the
+// number of groups; a transient shows up in the levels within the block that
+// carries it, where the FFT waits for its next 2048-sample frame.
+class BandFilterbank
+{
+public:
+    static constexpr int maxBands = 64;
+
+    // Allocates; call off the audio thread.
+    void prepare (double sampleRate, int numBands);
+    void reset() noexcept;
+
+    // right may be null for mono input; the bands follow the mono mix.
+    void process (const float* left, const float* right, int numSamples) noexcept;
+
+    int getNumBands() const noexcept  { return numBands; }
+
+    // Each band's envelope, scaled so a steady sine at a band centre reads as
+    // it does in AnalysisEngine's bands, and mapped to 0..1 the same way.
+    void getLevels (float* destination) const noexcept;
+
+    size_t getMemoryBytes() const noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int maxChunk = 256;
+
+    // A group of bands, one per lane. The band-pass has b1 = 0 and b2 = -b0;
+    // the feedback terms are stored negated.
+    struct Group
+    {
+        Vec b0, negA1, negA2;
+        Vec s1, s2, envelope;
+    };
+
+    std::vector<Group> groups;
+    std::vector<float> mono;
+    std::array<float, maxBands> levelScales {};
+    Vec release;
+    int numBands = 0;
+};
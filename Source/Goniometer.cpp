@@ -0,0 +1,121 @@
+#include "Goniometer.h"
+
+#include <cmath>
+
+namespace
+{
+    // Time for the trace to fall to 1/e, about a scope phosphor's persistence.
+    constexpr double persistenceSeconds = 0.15;
+
+    // Hits are weighted to this rate, so the trace is as bright at 192 kHz as at 48.
+    constexpr double referenceSampleRate = 48000.0;
+
+    // The trace reaches about 63% brightness at kneeDensity hits per pixel;
+    // the table tops out at maxDensity.
+    constexpr float kneeDensity = 4.0f;
+    constexpr float maxDensity = 32.0f;
+}
+
+Goniometer::Goniometer()
+{
+    setColours (juce::Colours::black, juce::Colours::white);
+}
+
+void Goniometer::setSize (int newSide)
+{
+    newSide = juce::jmax (0, newSide);
+
+    if (newSide == side)
+        return;
+
+    side = newSide;
+    density.assign ((size_t) (side * side), 0.0f);
+    indices.resize ((size_t) side);
+    image = side > 0 ? juce::Image (juce::Image::RGB, side, side, false, juce::SoftwareImageType()) : juce::Image();
+    peakDensity = 0.0f;
+    imageCleared = false;
+}
+
+void Goniometer::setSampleRate (double sampleRate) noexcept
+{
+    if (sampleRate > 0.0)
+        sampleWeight = (float) juce::jlimit (0.05, 4.0, referenceSampleRate / sampleRate);
+}
+
+void Goniometer::setColours (juce::Colour background, juce::Colour trace)
+{
+    for (size_t i = 0; i < lut.size(); ++i)
+    {
+        const float hits = maxDensity * (float) i / (float) (lutSize - 1);
+        const float brightness = 1.0f - std::exp (-hits / kneeDensity);
+
+        // The densest areas run on from the trace colour towards white.
+        const auto colour = brightness < 0.75f ? background.interpolatedWith (trace, brightness / 0.75f)
+                                               : trace.interpolatedWith (juce::Colours::white, (brightness - 0.75f) * 2.0f);
+        lut[i].setARGB (255, colour.getRed(), colour.getGreen(), colour.getBlue());
+    }
+
+    imageCleared = false;
+}
+
+// Mid and side of a sample within full scale both lie in [-1, 1]. Anything
+// beyond is pinned to the edge, and a NaN to the corner, rather than indexing
+// outside the buffer.
+void Goniometer::addSamples (const float* left, const float* right, int numSamples) noexcept
+{
+    if (side <= 0 || numSamples <= 0)
+        return;
+
+    const float half = (float) side * 0.5f;
+    const float last = (float) (side - 1);
+    auto* pixels = density.data();
+
+    auto toIndex = [last] (float position) noexcept
+    {
+        return (int) (position > 0.0f ? (position < last ? position : last) : 0.0f);
+    };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float mid = (left[i] + right[i]) * 0.5f;
+        const float spread = (right[i] - left[i]) * 0.5f;
+        pixels[toIndex (half - mid * half) * side + toIndex (half + spread * half)] += sampleWeight;
+    }
+
+    // As if every sample hit the same pixel; only used to tell when the trace has gone.
+    peakDensity += sampleWeight * (float) numSamples;
+}
+
+bool Goniometer::update (double elapsedSeconds)
+{
+    if (side <= 0)
+        return false;
+
+    // Below this every pixel maps to the first table entry.
+    const bool faded = peakDensity < maxDensity / (float) (lutSize - 1);
+
+    if (faded && imageCleared)
+        return false;
+
+    const float decay = (float) std::exp (-elapsedSeconds / persistenceSeconds);
+    juce::FloatVectorOperations::multiply (density.data(), decay, (int) density.size());
+    peakDensity *= decay;
+
+    const float toLut = (float) (lutSize - 1) / maxDensity;
+    juce::Image::BitmapData pixels (image, juce::Image::BitmapData::writeOnly);
+
+    for (int y = 0; y < side; ++y)
+    {
+        auto* row = indices.data();
+        juce::FloatVectorOperations::multiply (row, density.data() + y * side, toLut, side);
+        juce::FloatVectorOperations::min (row, row, (float) (lutSize - 1), side);
+
+        auto* line = reinterpret_cast<juce::PixelRGB*> (pixels.getLinePointer (y));
+
+        for (int x = 0; x < side; ++x)
+            line[x] = lut[(size_t) row[x]];
+    }
+
+    imageCleared = faded;
+    return true;
+}
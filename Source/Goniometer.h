@@ -0,0 +1,47 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// A goniometer: every stereo sample plotted as mid (up) against side
+// (across), so a mono signal is a vertical line, left-only leans to the
+// upper left and out-of-phase material spreads sideways.
+//
+// Samples land in a float density buffer, one count per hit pixel weighted
+// for the sample rate. Each frame the buffer decays with one vector multiply
+// and is tone-mapped into the image through a lookup table, so the cost per
+// frame follows the image size and the cost per sample is one add.
+//
+// Message thread only.
+class Goniometer
+{
+public:
+    Goniometer();
+
+    // Clears the trace if the size changes.
+    void setSize (int side);
+    void setSampleRate (double sampleRate) noexcept;
+    void setColours (juce::Colour background, juce::Colour trace);
+
+    void addSamples (const float* left, const float* right, int numSamples) noexcept;
+
+    // Decays the trace by elapsedSeconds and redraws the image. Returns false
+    // once the trace has faded out and the image no longer changes.
+    bool update (double elapsedSeconds);
+
+    const juce::Image& getImage() const noexcept  { return image; }
+
+private:
+    static constexpr int lutSize = 256;
+
+    std::vector<float> density;      // side * side, row-major
+    std::vector<float> indices;      // one row of LUT positions
+    std::array<juce::PixelRGB, lutSize> lut {};
+    juce::Image image;
+    int side = 0;
+
+    float sampleWeight = 1.0f;
+    float peakDensity = 0.0f;        // upper bound on any pixel's density
+    bool imageCleared = true;
+};
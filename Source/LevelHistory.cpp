@@ -0,0 +1,172 @@
+#include "LevelHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LevelHistory::prepare (double sampleRate)
+{
+    if (entries.empty())
+        entries.resize ((size_t) (numTiers * numSeries * capacity));
+
+    samplesPerEntry = juce::jmax (1, juce::roundToInt (sampleRate * secondsPerEntry (0)));
+    samplesInEntry = 0;
+    sumSquares = 0.0;
+    valuesInEntry = 0;
+    peak = 0.0f;
+}
+
+void LevelHistory::process (const float* left, const float* right, int numSamples, float momentaryLufs) noexcept
+{
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        const int count = juce::jmin (numSamples - offset, samplesPerEntry - samplesInEntry);
+
+        for (const auto* channel : { left, right })
+        {
+            if (channel == nullptr)
+                continue;
+
+            double sum = 0.0;
+            float channelPeak = 0.0f;
+
+            for (int i = 0; i < count; ++i)
+            {
+                const float x = channel[offset + i];
+                sum += x * x;
+                channelPeak = juce::jmax (channelPeak, std::abs (x));
+            }
+
+            sumSquares += sum;
+            peak = juce::jmax (peak, channelPeak);
+            valuesInEntry += count;
+        }
+
+        offset += count;
+        samplesInEntry += count;
+
+        if (samplesInEntry < samplesPerEntry)
+            break;
+
+        const auto rms = valuesInEntry > 0 ? std::sqrt (sumSquares / valuesInEntry) : 0.0;
+        const auto rmsDb = std::isfinite (rms) ? juce::Decibels::gainToDecibels ((float) rms, floorDb) : floorDb;
+        const auto peakDb = std::isfinite (peak) ? juce::Decibels::gainToDecibels (peak, floorDb) : floorDb;
+        const auto lufs = juce::jmax (floorDb, momentaryLufs);
+
+        Frame frame;
+        frame[level] = { rmsDb, juce::jmax (rmsDb, peakDb), rmsDb };
+        frame[loudness] = { lufs, lufs, lufs };
+        push (0, frame);
+
+        samplesInEntry = 0;
+        sumSquares = 0.0;
+        valuesInEntry = 0;
+        peak = 0.0f;
+    }
+}
+
+void LevelHistory::push (int tier, const Frame& frame) noexcept
+{
+    const auto index = written[(size_t) tier].load (std::memory_order_relaxed);
+
+    for (int series = 0; series < numSeries; ++series)
+        entryAt (tier, series, index) = frame[(size_t) series];
+
+    written[(size_t) tier].store (index + 1, std::memory_order_release);
+
+    if (tier + 1 >= numTiers)
+        return;
+
+    auto& tierAccumulators = accumulators[(size_t) tier + 1];
+    bool complete = false;
+
+    for (int series = 0; series < numSeries; ++series)
+    {
+        auto& accumulator = tierAccumulators[(size_t) series];
+        const auto& entry = frame[(size_t) series];
+
+        accumulator.min = accumulator.count == 0 ? entry.min : juce::jmin (accumulator.min, entry.min);
+        accumulator.max = accumulator.count == 0 ? entry.max : juce::jmax (accumulator.max, entry.max);
+        accumulator.sum += entry.mean;
+        complete = ++accumulator.count == fanOut;
+    }
+
+    if (! complete)
+        return;
+
+    Frame folded;
+
+    for (int series = 0; series < numSeries; ++series)
+    {
+        auto& accumulator = tierAccumulators[(size_t) series];
+        folded[(size_t) series] = { accumulator.min, accumulator.max, (float) (accumulator.sum / fanOut) };
+        accumulator = {};
+    }
+
+    push (tier + 1, folded);
+}
+
+void LevelHistory::summarise (Series series, double spanSeconds, Column* columns, int numColumns) const noexcept
+{
+    if (numColumns <= 0)
+        return;
+
+    std::fill (columns, columns + numColumns, Column {});
+
+    if (entries.empty())
+        return;
+
+    // Coarsest tier with at least one entry per column, then coarser still
+    // if that tier's ring does not reach back far enough.
+    const double secondsPerColumn = spanSeconds / numColumns;
+    int tier = 0;
+
+    while (tier + 1 < numTiers && secondsPerEntry (tier + 1) <= secondsPerColumn)
+        ++tier;
+
+    while (tier + 1 < numTiers && secondsPerEntry (tier) * (capacity - readerMargin) < spanSeconds)
+        ++tier;
+
+    const auto end = (double) written[(size_t) tier].load (std::memory_order_acquire);
+    const auto oldest = juce::jmax (0.0, end - (capacity - readerMargin));
+    const double entriesPerColumn = secondsPerColumn / secondsPerEntry (tier);
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const double from = std::floor (end - (numColumns - column) * entriesPerColumn);
+        const double to = juce::jmax (from + 1.0, std::floor (end - (numColumns - column - 1) * entriesPerColumn));
+
+        if (from < oldest || to > end)
+            continue;
+
+        auto& result = columns[column];
+        double sum = 0.0;
+
+        for (auto index = (juce::uint64) from; index < (juce::uint64) to; ++index)
+        {
+            const auto& entry = entryAt (tier, series, index);
+            result.min = result.valid ? juce::jmin (result.min, entry.min) : entry.min;
+            result.max = result.valid ? juce::jmax (result.max, entry.max) : entry.max;
+            result.valid = true;
+            sum += entry.mean;
+        }
+
+        result.mean = (float) (sum / (to - from));
+    }
+}
+
+double LevelHistory::getRecordedSeconds() const noexcept
+{
+    return (double) written[0].load (std::memory_order_acquire) * secondsPerEntry (0);
+}
+
+LevelHistory::Entry& LevelHistory::entryAt (int tier, int series, juce::uint64 index) noexcept
+{
+    return entries[(size_t) ((tier * numSeries + series) * capacity) + (size_t) (index % capacity)];
+}
+
+const LevelHistory::Entry& LevelHistory::entryAt (int tier, int series, juce::uint64 index) const noexcept
+{
+    return entries[(size_t) ((tier * numSeries + series) * capacity) + (size_t) (index % capacity)];
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Level and loudness over time, kept as a min/max/mean pyramid: 10 ms entries,
+// then every ten of those folded into a 100 ms entry, and so on up to 10 s.
+// Each tier is a fixed ring, so memory never grows: the 10 s tier alone holds
+// more than eleven hours, the 1 s tier just over an hour. A reader asking for
+// any span picks the tier that gives at most ten entries per column, so
+// drawing costs O(columns) at every zoom.
+//
+// One writer (the audio thread) and one reader (the editor). Entries are
+// written before the tier's count is released; the reader stays clear of the
+// oldest entries of each ring, which the writer may be overwriting.
+class LevelHistory
+{
+public:
+    enum Series
+    {
+        level,      // per 10 ms: min = mean = RMS, max = sample peak
+        loudness,   // momentary loudness, sampled every 10 ms
+        numSeries
+    };
+
+    static constexpr int numTiers = 4;
+    static constexpr int fanOut = 10;
+    static constexpr int capacity = 4096;
+    static constexpr float floorDb = -100.0f;
+
+    struct Entry
+    {
+        float min = floorDb, max = floorDb, mean = floorDb;
+    };
+
+    struct Column
+    {
+        float min = floorDb, max = floorDb, mean = floorDb;
+        bool valid = false;
+    };
+
+    static constexpr double secondsPerEntry (int tier) noexcept
+    {
+        double seconds = 0.01;
+        for (int i = 0; i < tier; ++i)
+            seconds *= fanOut;
+        return seconds;
+    }
+
+    static constexpr double getMaxSpanSeconds() noexcept  { return secondsPerEntry (numTiers - 1) * capacity; }
+
+    // Allocates on the first call only. The history itself survives later
+    // calls, including rate changes: it is indexed in time, not samples.
+    void prepare (double sampleRate);
+
+    // Audio thread. right may be null for mono input.
+    void process (const float* left, const float* right, int numSamples, float momentaryLufs) noexcept;
+
+    // Reader. Fills numColumns columns covering the last spanSeconds, oldest
+    // first; columns before the start of the history are left invalid.
+    void summarise (Series series, double spanSeconds, Column* columns, int numColumns) const noexcept;
+
+    double getRecordedSeconds() const noexcept;
+    size_t getMemoryBytes() const noexcept  { return entries.capacity() * sizeof (Entry); }
+
+private:
+    // Entries the reader leaves alone at the old end of each ring.
+    static constexpr int readerMargin = 64;
+
+    struct Accumulator
+    {
+        float min = 0.0f, max = 0.0f;
+        double sum = 0.0;
+        int count = 0;
+    };
+
+    using Frame = std::array<Entry, numSeries>;
+
+    void push (int tier, const Frame& frame) noexcept;
+    Entry& entryAt (int tier, int series, juce::uint64 index) noexcept;
+    const Entry& entryAt (int tier, int series, juce::uint64 index) const noexcept;
+
+    std::vector<Entry> entries;    // [tier][series][capacity]
+    std::array<std::atomic<juce::uint64>, numTiers> written {};
+    std::array<std::array<Accumulator, numSeries>, numTiers> accumulators {};
+
+    int samplesPerEntry = 441;
+    int samplesInEntry = 0;
+    double sumSquares = 0.0;
+    int valuesInEntry = 0;
+    float peak = 0.0f;
+};
@@ -0,0 +1,256 @@
+#include "LoudnessMeter.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr float relativeGateIntegrated = -10.0f;
+    constexpr float relativeGateRange = -20.0f;
+
+    float toLufs (double meanSquare) noexcept
+    {
+        if (meanSquare <= 0.0)
+            return LoudnessMeter::silenceLufs;
+
+        return juce::jmax (LoudnessMeter::silenceLufs, static_cast<float> (-0.691 + 10.0 * std::log10 (meanSquare)));
+    }
+}
+
+// ─── Histogram ────────────────────────────────────────────────────────────────
+
+void LoudnessMeter::Histogram::add (double energy, float lufs) noexcept
+{
+    if (lufs < histogramFloor)
+        return;
+
+    const auto bin = juce::jlimit (0, numBins - 1, static_cast<int> ((lufs - histogramFloor) * binsPerLu));
+    ++counts[(size_t) bin];
+    energies[(size_t) bin] += energy;
+    ++total;
+    totalEnergy += energy;
+}
+
+void LoudnessMeter::Histogram::clear() noexcept
+{
+    counts.fill (0);
+    energies.fill (0.0);
+    total = 0;
+    totalEnergy = 0.0;
+}
+
+// ─── LoudnessMeter ────────────────────────────────────────────────────────────
+
+void LoudnessMeter::prepare (double sampleRate)
+{
+    // K-weighting from BS.1770 Annex 1, re-derived for the actual rate rather
+    // than using the published 48 kHz coefficients.
+    {
+        constexpr double f0 = 1681.974450955533;
+        constexpr double gainDb = 3.999843853973347;
+        constexpr double q = 0.7071752369554196;
+
+        const double k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow (10.0, gainDb / 20.0);
+        const double vb = std::pow (vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    {
+        constexpr double f0 = 38.13547087602444;
+        constexpr double q = 0.5003270373238773;
+
+        const double k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    samplesPerBlock = juce::jmax (1, juce::roundToInt (sampleRate / 10.0));
+    reset();
+}
+
+void LoudnessMeter::reset() noexcept
+{
+    channels = {};
+    blockEnergies.fill (0.0);
+    blockIndex = 0;
+    blocksSeen = 0;
+    samplesInBlock = 0;
+    blockEnergy = 0.0;
+    momentaryHistogram.clear();
+    shortTermHistogram.clear();
+    results = {};
+}
+
+bool LoudnessMeter::process (const float* left, const float* right, int numSamples) noexcept
+{
+    bool updated = false;
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        const int count = juce::jmin (numSamples - offset, samplesPerBlock - samplesInBlock);
+
+        // Both channels carry a weight of 1.0 in BS.1770.
+        blockEnergy += filterChannel (left + offset, count, channels[0]);
+
+        if (right != nullptr)
+            blockEnergy += filterChannel (right + offset, count, channels[1]);
+
+        offset += count;
+        samplesInBlock += count;
+
+        if (samplesInBlock == samplesPerBlock)
+        {
+            completeBlock();
+            updated = true;
+        }
+    }
+
+    return updated;
+}
+
+// Runs both K-weighting stages in transposed direct form II and returns the
+// sum of squares of the weighted output.
+double LoudnessMeter::filterChannel (const float* input, int numSamples, ChannelState& state) const noexcept
+{
+    const auto s = shelf;
+    const auto h = highPass;
+    double s1 = state.s1, s2 = state.s2, s3 = state.s3, s4 = state.s4;
+    double sum = 0.0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double x = input[i];
+
+        const double y1 = s.b0 * x + s1;
+        s1 = s.b1 * x - s.a1 * y1 + s2;
+        s2 = s.b2 * x - s.a2 * y1;
+
+        const double y2 = h.b0 * y1 + s3;
+        s3 = h.b1 * y1 - h.a1 * y2 + s4;
+        s4 = h.b2 * y1 - h.a2 * y2;
+
+        sum += y2 * y2;
+    }
+
+    state = { s1, s2, s3, s4 };
+    return sum;
+}
+
+void LoudnessMeter::completeBlock() noexcept
+{
+    // A non-finite input would otherwise poison the filters for good.
+    if (! std::isfinite (blockEnergy))
+    {
+        channels = {};
+        blockEnergy = 0.0;
+    }
+
+    blockEnergies[(size_t) blockIndex] = blockEnergy / samplesPerBlock;
+    blockIndex = (blockIndex + 1) % blocksPerShortTerm;
+    blocksSeen = juce::jmin (blocksSeen + 1, blocksPerShortTerm);
+    samplesInBlock = 0;
+    blockEnergy = 0.0;
+
+    const auto meanOfLast = [this] (int numBlocks)
+    {
+        double sum = 0.0;
+
+        for (int i = 1; i <= numBlocks; ++i)
+            sum += blockEnergies[(size_t) ((blockIndex - i + blocksPerShortTerm) % blocksPerShortTerm)];
+
+        return sum / numBlocks;
+    };
+
+    // Each 100 ms step closes a 400 ms gating block with 75 % overlap.
+    if (blocksSeen >= blocksPerMomentary)
+    {
+        const double energy = meanOfLast (blocksPerMomentary);
+        results.momentary = toLufs (energy);
+        momentaryHistogram.add (energy, results.momentary);
+        results.integrated = computeIntegrated();
+    }
+
+    // Tech 3342 asks for short-term values at 10 Hz or more; every step is used.
+    if (blocksSeen >= blocksPerShortTerm)
+    {
+        const double energy = meanOfLast (blocksPerShortTerm);
+        results.shortTerm = toLufs (energy);
+        shortTermHistogram.add (energy, results.shortTerm);
+        results.range = computeRange();
+    }
+}
+
+// Bins at or above the one holding the relative gate are summed; the gate is
+// therefore resolved to 0.1 LU, while the energies themselves are exact.
+float LoudnessMeter::computeIntegrated() const noexcept
+{
+    const auto& histogram = momentaryHistogram;
+
+    if (histogram.total == 0)
+        return silenceLufs;
+
+    const float gate = toLufs (histogram.totalEnergy / static_cast<double> (histogram.total)) + relativeGateIntegrated;
+    const auto firstBin = juce::jlimit (0, numBins - 1, static_cast<int> ((gate - histogramFloor) * binsPerLu));
+
+    juce::uint64 count = 0;
+    double energy = 0.0;
+
+    for (int bin = firstBin; bin < numBins; ++bin)
+    {
+        count += histogram.counts[(size_t) bin];
+        energy += histogram.energies[(size_t) bin];
+    }
+
+    return count > 0 ? toLufs (energy / static_cast<double> (count)) : silenceLufs;
+}
+
+// LRA is the spread between the 10th and 95th percentiles of the gated
+// short-term distribution, read off the histogram at bin centres.
+float LoudnessMeter::computeRange() const noexcept
+{
+    const auto& histogram = shortTermHistogram;
+
+    if (histogram.total == 0)
+        return 0.0f;
+
+    const float gate = toLufs (histogram.totalEnergy / static_cast<double> (histogram.total)) + relativeGateRange;
+    const auto firstBin = juce::jlimit (0, numBins - 1, static_cast<int> ((gate - histogramFloor) * binsPerLu));
+
+    juce::uint64 count = 0;
+
+    for (int bin = firstBin; bin < numBins; ++bin)
+        count += histogram.counts[(size_t) bin];
+
+    if (count == 0)
+        return 0.0f;
+
+    const auto percentile = [&] (double fraction)
+    {
+        const auto rank = static_cast<juce::uint64> (fraction * static_cast<double> (count - 1));
+        juce::uint64 cumulative = 0;
+
+        for (int bin = firstBin; bin < numBins; ++bin)
+        {
+            cumulative += histogram.counts[(size_t) bin];
+
+            if (cumulative > rank)
+                return histogramFloor + (static_cast<float> (bin) + 0.5f) / binsPerLu;
+        }
+
+        return histogramFloor + static_cast<float> (numBins) / binsPerLu;
+    };
+
+    return percentile (0.95) - percentile (0.10);
+}
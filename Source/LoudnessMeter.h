@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// ITU-R BS.1770-4 / EBU R128 loudness: momentary (400 ms), short-term (3 s),
+// gated integrated loudness and EBU Tech 3342 loudness range. The K-weighted
+// signal is reduced to one energy value per 100 ms; gating works on
+// histograms of those values, so memory does not grow with the programme.
+class LoudnessMeter
+{
+public:
+    // Reported for anything below the absolute gate or not yet measured.
+    static constexpr float silenceLufs = -100.0f;
+
+    struct Results
+    {
+        float momentary = silenceLufs;
+        float shortTerm = silenceLufs;
+        float integrated = silenceLufs;
+        float range = 0.0f;
+    };
+
+    void prepare (double sampleRate);
+    void reset() noexcept;
+
+    // right may be null for mono input. Returns true if at least one 100 ms
+    // step completed, i.e. getResults() has changed.
+    bool process (const float* left, const float* right, int numSamples) noexcept;
+
+    const Results& getResults() const noexcept  { return results; }
+
+private:
+    static constexpr int blocksPerMomentary = 4;
+    static constexpr int blocksPerShortTerm = 30;
+
+    // 0.1 LU bins from the -70 LUFS absolute gate up to +10 LUFS.
+    static constexpr float histogramFloor = -70.0f;
+    static constexpr int binsPerLu = 10;
+    static constexpr int numBins = 80 * binsPerLu;
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    struct ChannelState
+    {
+        double s1 = 0.0, s2 = 0.0;   // pre-filter (high shelf)
+        double s3 = 0.0, s4 = 0.0;   // RLB high-pass
+    };
+
+    struct Histogram
+    {
+        std::array<juce::uint32, numBins> counts {};
+        std::array<double, numBins> energies {};
+        juce::uint64 total = 0;
+        double totalEnergy = 0.0;
+
+        void add (double energy, float lufs) noexcept;
+        void clear() noexcept;
+    };
+
+    double filterChannel (const float* input, int numSamples, ChannelState& state) const noexcept;
+    void completeBlock() noexcept;
+    float computeIntegrated() const noexcept;
+    float computeRange() const noexcept;
+
+    Biquad shelf, highPass;
+    std::array<ChannelState, 2> channels;
+
+    std::array<double, blocksPerShortTerm> blockEnergies {};
+    int blockIndex = 0;
+    int blocksSeen = 0;
+    int samplesPerBlock = 4800;
+    int samplesInBlock = 0;
+    double blockEnergy = 0.0;
+
+    Histogram momentaryHistogram;
+    Histogram shortTermHistogram;
+    Results results;
+};
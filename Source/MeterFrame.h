@@ -0,0 +1,198 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisEngine.h"
+#include "LoudnessMeter.h"
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+// Everything the editor draws from the processor, published as one unit so a
+// GUI frame never mixes values from different blocks.
+struct MeterFrame
+{
+    static constexpr int numBands = AnalysisEngine::numBands;
+
+    juce::uint64 sequence = 0;      // frames published since construction
+    juce::uint64 endSample = 0;     // samples processed up to this frame
+    double sampleRate = 44100.0;
+
+    // Host transport at endSample, for tempo-synced displays. bpm and ppq
+    // are 0 unless the host is playing and reports both.
+    bool transportPlaying = false;
+    double bpm = 0.0;
+    double ppqAtEnd = 0.0;
+
+    float leftLevel = 0.0f, rightLevel = 0.0f;   // 0..1, with ballistics
+    float leftPeakDb = -100.0f, rightPeakDb = -100.0f;
+    float leftRmsDb = -100.0f, rightRmsDb = -100.0f;
+    float correlation = 0.0f;
+    float width = 0.0f;
+    float autoGainDb = 0.0f;
+    float limiterReductionDb = 0.0f;
+    float globalRms = 0.0f;
+    std::array<float, numBands> bands {};
+    bool bandFilterbank = false;   // bands come from BandFilterbank, not the FFT
+
+    // Stereo image per band, smoothed like the band levels; see
+    // AnalysisEngine::StereoBands.
+    std::array<float, numBands> bandCorrelation {}, bandWidth {}, bandBalance {};
+
+    float momentaryLufs = LoudnessMeter::silenceLufs;
+    float shortTermLufs = LoudnessMeter::silenceLufs;
+    float integratedLufs = LoudnessMeter::silenceLufs;
+    float loudnessRange = 0.0f;
+
+    float truePeakLeftDb = -100.0f, truePeakRightDb = -100.0f;
+    float truePeakHoldDb = -100.0f;
+    int truePeakOvers = 0;
+
+    // The main signal against the sidechain key, while the host has the
+    // sidechain connected; see SpectralComparison.
+    bool sidechainActive = false;
+    std::array<float, numBands> sidechainBands {}, sidechainDifferenceDb {}, sidechainMasking {};
+
+    bool referenceActive = false;
+    float referenceLeftRmsDb = -100.0f, referenceRightRmsDb = -100.0f;
+    std::array<float, numBands> referenceBands {};
+
+    // Merges a frame the queue had no room for into the one after it: the
+    // newer frame's values with the louder of the two peaks, so a transient
+    // survives a reader that falls behind.
+    struct Fold
+    {
+        static void apply (MeterFrame& newer, const MeterFrame& older) noexcept
+        {
+            newer.leftPeakDb = juce::jmax (newer.leftPeakDb, older.leftPeakDb);
+            newer.rightPeakDb = juce::jmax (newer.rightPeakDb, older.rightPeakDb);
+            newer.truePeakLeftDb = juce::jmax (newer.truePeakLeftDb, older.truePeakLeftDb);
+            newer.truePeakRightDb = juce::jmax (newer.truePeakRightDb, older.truePeakRightDb);
+        }
+    };
+};
+
+static_assert (std::is_trivially_copyable_v<MeterFrame>, "frames are copied by value between threads");
+
+// Single-writer, single-reader hand-off of the newest frame. The reader always
+// sees a complete frame and the writer never waits; frames published between
+// two reads are skipped.
+template <typename Frame>
+class TripleBuffer
+{
+public:
+    static_assert (std::is_trivially_copyable_v<Frame>, "frames are copied by value between threads");
+
+    // Writer side.
+    void publish (const Frame& frame) noexcept
+    {
+        slots[(size_t) backIndex].frame = frame;
+        backIndex = middle.exchange (backIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader side: copies the newest frame and returns true if one has been
+    // published since the last call.
+    bool readLatest (Frame& destination) noexcept
+    {
+        if ((middle.load (std::memory_order_acquire) & freshBit) == 0)
+            return false;
+
+        frontIndex = middle.exchange (frontIndex, std::memory_order_acq_rel) & indexMask;
+        destination = slots[(size_t) frontIndex].frame;
+        return true;
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshBit = 4;
+
+    // One cache line or more per slot, so the writer filling one never
+    // invalidates the line the reader is copying from.
+    struct alignas (64) Slot
+    {
+        Frame frame {};
+    };
+
+    std::array<Slot, 3> slots;
+    alignas (64) std::atomic<int> middle { 1 };
+    alignas (64) int backIndex = 0;      // writer only
+    alignas (64) int frontIndex = 2;     // reader only
+};
+
+// A TripleBuffer that also queues every published frame, for readers that
+// need each block rather than the latest. When the queue is full, new frames
+// are counted as dropped. With a Fold type they are also held back and
+// merged, Fold::apply (newer, older), into each following frame until there
+// is room again, so what they carried still reaches the reader.
+template <typename Frame, int queueSize = 128, typename Fold = void>
+class FrameExchange
+{
+public:
+    // Writer side.
+    void publish (const Frame& frame) noexcept
+    {
+        latest.publish (frame);
+
+        if constexpr (std::is_void_v<Fold>)
+        {
+            if (! enqueue (frame))
+                dropped.fetch_add (1, std::memory_order_relaxed);
+        }
+        else
+        {
+            Frame next = frame;
+
+            if (hasPending)
+            {
+                Fold::apply (next, pending);
+                hasPending = false;
+            }
+
+            if (! enqueue (next))
+            {
+                pending = next;
+                hasPending = true;
+                dropped.fetch_add (1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Reader side.
+    bool readLatest (Frame& destination) noexcept  { return latest.readLatest (destination); }
+
+    // Reader side: calls onFrame (const Frame&) for each queued frame, oldest
+    // first, and returns how many there were.
+    template <typename Callback>
+    int drainQueue (Callback&& onFrame)
+    {
+        const auto scope = fifo.read (fifo.getNumReady());
+
+        for (int i = 0; i < scope.blockSize1; ++i)
+            onFrame (queue[(size_t) (scope.startIndex1 + i)]);
+
+        for (int i = 0; i < scope.blockSize2; ++i)
+            onFrame (queue[(size_t) (scope.startIndex2 + i)]);
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    juce::uint32 getDroppedCount() const noexcept  { return dropped.load (std::memory_order_relaxed); }
+
+private:
+    bool enqueue (const Frame& frame) noexcept
+    {
+        const auto scope = fifo.write (1);
+
+        if (scope.blockSize1 == 0)
+            return false;
+
+        queue[(size_t) scope.startIndex1] = frame;
+        return true;
+    }
+
+    TripleBuffer<Frame> latest;
+    juce::AbstractFifo fifo { queueSize };
+    std::array<Frame, (size_t) queueSize> queue {};
+    std::atomic<juce::uint32> dropped { 0 };
+    Frame pending {};          // writer only
+    bool hasPending = false;   // writer only
+};
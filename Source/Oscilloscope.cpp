@@ -0,0 +1,341 @@
+#include "Oscilloscope.h"
+
+#include <cmath>
+#include <tuple>
+
+namespace
+{
+    // Edges cross zero; the signal must first go this far the other way.
+    constexpr float hysteresis = 0.01f;
+
+    // An edge older than this, past the end of its window, is stale and the
+    // scope runs free instead of freezing on it.
+    constexpr double autoSeconds = 0.1;
+
+    // Tempo mode windows, in beats, as powers of two.
+    constexpr double minBeatsLog2 = -4.0;   // a sixteenth note
+    constexpr double maxBeatsLog2 = 6.0;    // sixteen bars of 4/4
+
+    juce::uint64 samplesPerEntry (int level) noexcept  { return juce::uint64 (1) << (2 * level); }
+}
+
+Oscilloscope::Oscilloscope()
+{
+    for (auto& level : levels)
+        level.resize ((size_t) levelSize);
+}
+
+void Oscilloscope::setArea (juce::Rectangle<float> newArea)
+{
+    if (newArea == area)
+        return;
+
+    area = newArea;
+    const auto numColumns = (size_t) juce::jmax (0, juce::roundToInt (area.getWidth()));
+    columns.resize (numColumns);
+    shownColumns.clear();
+
+    // Top edge out, bottom edge back, and the close.
+    trace.preallocateSpace (6 * (int) numColumns + 3);
+}
+
+void Oscilloscope::setTrigger (Trigger newTrigger) noexcept
+{
+    if (newTrigger == trigger)
+        return;
+
+    // Every mode but falling tracks rising edges. Those stay valid across the
+    // switch; edges of the other polarity do not.
+    const bool polarityChanged = (newTrigger == Trigger::falling) != (trigger == Trigger::falling);
+    trigger = newTrigger;
+
+    if (polarityChanged)
+    {
+        numTriggers = 0;
+        newestTrigger = -1;
+        armed = false;
+    }
+}
+
+void Oscilloscope::setTimebase (double seconds) noexcept
+{
+    timebaseSeconds = juce::jlimit (minTimebaseSeconds, maxTimebaseSeconds, seconds);
+}
+
+void Oscilloscope::setSampleRate (double newSampleRate)
+{
+    if (newSampleRate <= 0.0 || newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+    reset (origin + written);
+}
+
+void Oscilloscope::reset (juce::uint64 firstSample) noexcept
+{
+    origin = firstSample;
+    written = 0;
+    counts = {};
+    pendingCount = {};
+    numTriggers = 0;
+    newestTrigger = -1;
+    armed = false;
+    holdoffUntil = 0;
+}
+
+// ─── Capture ────────────────────────────────────────────────────────────────
+
+void Oscilloscope::addSamples (juce::uint64 firstSample, const float* left, const float* right, int numSamples) noexcept
+{
+    if (sampleRate <= 0.0 || numSamples <= 0)
+        return;
+
+    if (firstSample != origin + written)
+        reset (firstSample);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto mid = (left[i] + right[i]) * 0.5f;
+
+        if (std::isnan (mid))
+            mid = 0.0f;
+
+        detectEdge (mid);
+        push (mid);
+    }
+}
+
+// Every fourth entry completed at one level completes one at the next.
+void Oscilloscope::push (float sample) noexcept
+{
+    Extent completed { sample, sample };
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        if (level > 0)
+        {
+            auto& partial = pending[(size_t) level];
+            auto& count = pendingCount[(size_t) level];
+
+            partial = count == 0 ? completed
+                                 : Extent { juce::jmin (partial.min, completed.min), juce::jmax (partial.max, completed.max) };
+
+            if (++count < 4)
+                break;
+
+            count = 0;
+            completed = partial;
+        }
+
+        levels[(size_t) level][counts[(size_t) level] & (juce::uint64) (levelSize - 1)] = completed;
+        ++counts[(size_t) level];
+    }
+
+    ++written;
+}
+
+// Falling edges are found as rising edges of the inverted signal. Rising edges
+// are tracked in free run and tempo sync too, so switching from either to the
+// rising trigger has some ready; setTrigger drops them when the polarity flips.
+void Oscilloscope::detectEdge (float sample) noexcept
+{
+    const float value = trigger == Trigger::falling ? -sample : sample;
+
+    if (value < -hysteresis)
+    {
+        armed = true;
+        return;
+    }
+
+    if (! armed || value < 0.0f)
+        return;
+
+    armed = false;
+
+    if (written < holdoffUntil)
+        return;
+
+    newestTrigger = (newestTrigger + 1) % maxTriggers;
+    triggers[(size_t) newestTrigger] = written;
+    numTriggers = juce::jmin (numTriggers + 1, maxTriggers);
+    holdoffUntil = written + (juce::uint64) (timebaseSeconds * sampleRate * 0.25);
+}
+
+// ─── Drawing ────────────────────────────────────────────────────────────────
+
+juce::uint64 Oscilloscope::oldestEntry (int level) const noexcept
+{
+    const auto count = counts[(size_t) level];
+    return count > (juce::uint64) levelSize ? count - (juce::uint64) levelSize : 0;
+}
+
+const Oscilloscope::Extent& Oscilloscope::entry (int level, juce::uint64 index) const noexcept
+{
+    static_assert (juce::isPowerOfTwo (levelSize), "entries are found by masking");
+    return levels[(size_t) level][index & (juce::uint64) (levelSize - 1)];
+}
+
+// Returns the window start in samples since origin, and sets the length and
+// how it was found.
+double Oscilloscope::chooseWindow (double length) noexcept
+{
+    triggered = false;
+    windowBeats = 0.0;
+    windowSeconds = length / sampleRate;
+
+    const double latestStart = juce::jmax (0.0, (double) written - length);
+
+    if (trigger == Trigger::tempo)
+    {
+        if (! transport.playing || transport.bpm <= 0.0)
+            return latestStart;
+
+        const double samplesPerBeat = sampleRate * 60.0 / transport.bpm;
+        const double maxLog2 = juce::jmin (maxBeatsLog2, std::floor (std::log2 (maxTimebaseSeconds * sampleRate / samplesPerBeat)));
+        const double beats = std::exp2 (juce::jlimit (minBeatsLog2, juce::jmax (minBeatsLog2, maxLog2),
+                                                      std::round (std::log2 (length / samplesPerBeat))));
+        windowBeats = beats;
+        windowSeconds = beats * samplesPerBeat / sampleRate;
+
+        // The newest multiple of the window, in beats, that a full window fits behind.
+        const double transportSample = (double) transport.sample - (double) origin;
+        const double ppqAtLatest = transport.ppq + ((double) written - beats * samplesPerBeat - transportSample) / samplesPerBeat;
+        const double start = transportSample + (std::floor (ppqAtLatest / beats) * beats - transport.ppq) * samplesPerBeat;
+
+        if (start < 0.0)
+            return latestStart;
+
+        triggered = true;
+        return start;
+    }
+
+    if (trigger == Trigger::freeRun)
+        return latestStart;
+
+    const double staleAfter = juce::jmax (length, autoSeconds * sampleRate);
+
+    for (int i = 0; i < numTriggers; ++i)
+    {
+        const auto edge = (double) triggers[(size_t) ((newestTrigger - i + maxTriggers) % maxTriggers)];
+
+        if (edge > latestStart)
+            continue;
+
+        if (latestStart - edge <= staleAfter)
+        {
+            triggered = true;
+            return edge;
+        }
+
+        break;
+    }
+
+    return latestStart;
+}
+
+Oscilloscope::Extent Oscilloscope::columnExtent (int level, double from, double to) const noexcept
+{
+    const double scale = (double) samplesPerEntry (level);
+    const auto count = counts[(size_t) level];
+
+    if (count == 0)
+        return {};
+
+    auto first = (juce::uint64) juce::jmax (0.0, std::floor (from / scale));
+    auto last = (juce::uint64) juce::jmax (0.0, std::ceil (to / scale));
+    first = juce::jlimit (oldestEntry (level), count - 1, first);
+    last = juce::jlimit (first + 1, count, last);
+
+    auto extent = entry (level, first);
+
+    for (auto index = first + 1; index < last; ++index)
+    {
+        const auto& next = entry (level, index);
+        extent.min = juce::jmin (extent.min, next.min);
+        extent.max = juce::jmax (extent.max, next.max);
+    }
+
+    return extent;
+}
+
+// Linear between the two nearest samples, for windows with fewer samples
+// than columns.
+float Oscilloscope::valueAt (double sample) const noexcept
+{
+    const auto count = counts[0];
+
+    if (count == 0)
+        return 0.0f;
+
+    const double clamped = juce::jlimit ((double) oldestEntry (0), (double) (count - 1), sample);
+    const auto below = (juce::uint64) clamped;
+    const auto above = juce::jmin (below + 1, count - 1);
+    const auto fraction = (float) (clamped - (double) below);
+
+    return entry (0, below).min + fraction * (entry (0, above).min - entry (0, below).min);
+}
+
+bool Oscilloscope::update()
+{
+    if (sampleRate <= 0.0 || columns.empty())
+        return false;
+
+    const auto shownState = std::make_tuple (windowSeconds, windowBeats, triggered);
+    const double start = chooseWindow (timebaseSeconds * sampleRate);
+    const double length = windowSeconds * sampleRate;
+    const double samplesPerColumn = length / (double) columns.size();
+
+    // The coarsest level still finer than a column, moved up if the finer
+    // levels no longer hold the start of the window.
+    int level = juce::jlimit (0, numLevels - 1, (int) std::floor (std::log2 (juce::jmax (1.0, samplesPerColumn)) * 0.5));
+
+    while (level < numLevels - 1 && start < (double) (oldestEntry (level) * samplesPerEntry (level)))
+        ++level;
+
+    for (size_t column = 0; column < columns.size(); ++column)
+    {
+        const double from = start + (double) column * samplesPerColumn;
+
+        if (level == 0 && samplesPerColumn < 1.0)
+        {
+            const auto value = valueAt (from + samplesPerColumn * 0.5);
+            columns[column] = { value, value };
+        }
+        else
+        {
+            columns[column] = columnExtent (level, from, from + samplesPerColumn);
+        }
+    }
+
+    // Compared in pixels, so a trace that only shifts by rounding is not
+    // redrawn. A new window or trigger state still changes the caption.
+    const float halfHeight = area.getHeight() * 0.5f;
+    const bool captionChanged = shownState != std::make_tuple (windowSeconds, windowBeats, triggered);
+    bool moved = shownColumns.size() != columns.size();
+
+    for (size_t column = 0; ! moved && column < columns.size(); ++column)
+        moved = std::abs (columns[column].min - shownColumns[column].min) * halfHeight >= 0.5f
+             || std::abs (columns[column].max - shownColumns[column].max) * halfHeight >= 0.5f;
+
+    if (! moved)
+        return captionChanged;
+
+    shownColumns = columns;
+
+    auto toY = [this, halfHeight] (float value)
+    {
+        return area.getCentreY() - juce::jlimit (-1.0f, 1.0f, value) * halfHeight;
+    };
+
+    trace.clear();
+    trace.startNewSubPath (area.getX() + 0.5f, toY (columns.front().max));
+
+    for (size_t column = 1; column < columns.size(); ++column)
+        trace.lineTo (area.getX() + (float) column + 0.5f, toY (columns[column].max));
+
+    for (size_t column = columns.size(); column-- > 0;)
+        trace.lineTo (area.getX() + (float) column + 0.5f, toY (columns[column].min));
+
+    trace.closeSubPath();
+    return true;
+}
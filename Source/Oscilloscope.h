@@ -0,0 +1,115 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// A triggered waveform display of the mid signal, (L + R) / 2.
+//
+// Samples are kept in a pyramid of min/max rings: level 0 holds single
+// samples and each level above summarises four entries of the one below.
+// The pyramid is extended as samples arrive, at an amortised 4/3 ring
+// writes per sample. A window of any length, from 1 ms to 10 s, is drawn
+// from the level whose entries are just finer than one pixel column, so a
+// column reads at most a few entries and a redraw is O(columns).
+//
+// Edges are found as samples arrive, with hysteresis and a holdoff of a
+// quarter of the window, and the window starts at the newest edge it fits
+// behind. Without a recent edge the scope runs free. In tempo mode the
+// window is a power-of-two number of beats and starts on a multiple of it,
+// from the host position published with the meter frames.
+//
+// Message thread only.
+class Oscilloscope
+{
+public:
+    // Ids match the trigger combo box items.
+    enum class Trigger
+    {
+        freeRun = 1,
+        rising,
+        falling,
+        tempo
+    };
+
+    // Host transport at one sample position, as counted by the SampleRing.
+    struct Transport
+    {
+        juce::uint64 sample = 0;
+        double ppq = 0.0, bpm = 0.0;
+        bool playing = false;
+    };
+
+    static constexpr double minTimebaseSeconds = 0.001;
+    static constexpr double maxTimebaseSeconds = 10.0;
+
+    Oscilloscope();
+
+    void setArea (juce::Rectangle<float> area);
+    void setTrigger (Trigger) noexcept;
+    Trigger getTrigger() const noexcept  { return trigger; }
+    void setTimebase (double seconds) noexcept;
+    double getTimebase() const noexcept  { return timebaseSeconds; }
+
+    // Clears the pyramid if the rate changes.
+    void setSampleRate (double sampleRate);
+    void setTransport (const Transport& newTransport) noexcept  { transport = newTransport; }
+
+    // firstSample is the ring position of left[0]. A gap since the last call
+    // restarts the pyramid there.
+    void addSamples (juce::uint64 firstSample, const float* left, const float* right, int numSamples) noexcept;
+
+    // Picks the window for the trigger mode and rebuilds the trace. Returns
+    // false if no column moved.
+    bool update();
+
+    const juce::Path& getTrace() const noexcept  { return trace; }
+
+    // The window last drawn, and whether it started on an edge or beat.
+    double getWindowSeconds() const noexcept     { return windowSeconds; }
+    double getWindowBeats() const noexcept       { return windowBeats; }
+    bool isTriggered() const noexcept            { return triggered; }
+
+private:
+    struct Extent
+    {
+        float min = 0.0f, max = 0.0f;
+    };
+
+    static constexpr int numLevels = 9;           // down to 4^8 samples per entry
+    static constexpr int levelSize = 8192;        // entries per level
+    static constexpr int maxTriggers = 64;
+
+    void reset (juce::uint64 firstSample) noexcept;
+    void push (float sample) noexcept;
+    void detectEdge (float sample) noexcept;
+    juce::uint64 oldestEntry (int level) const noexcept;
+    const Extent& entry (int level, juce::uint64 index) const noexcept;
+    double chooseWindow (double length) noexcept;
+    Extent columnExtent (int level, double from, double to) const noexcept;
+    float valueAt (double sample) const noexcept;
+
+    juce::Rectangle<float> area;
+    Trigger trigger = Trigger::rising;
+    double timebaseSeconds = 0.02;
+    double sampleRate = 0.0;
+    Transport transport;
+
+    std::array<std::vector<Extent>, numLevels> levels;
+    std::array<juce::uint64, numLevels> counts {};  // complete entries per level
+    std::array<Extent, numLevels> pending {};       // the entry being built, per level
+    std::array<int, numLevels> pendingCount {};
+    juce::uint64 origin = 0;                        // ring position of the first sample kept
+    juce::uint64 written = 0;                       // samples since origin
+
+    // Edge detection on the raw samples, in samples since origin.
+    std::array<juce::uint64, maxTriggers> triggers {};
+    int numTriggers = 0, newestTrigger = -1;
+    bool armed = false;
+    juce::uint64 holdoffUntil = 0;
+
+    std::vector<Extent> columns, shownColumns;
+    juce::Path trace;
+    double windowSeconds = 0.0, windowBeats = 0.0;
+    bool triggered = false;
+};
@@ -0,0 +1,45 @@
+#include "PairedFft.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+
+void PairedFft::prepare()
+{
+    // The size never changes, so the FFT is only ever built once.
+    if (fft != nullptr)
+        return;
+
+    fft = std::make_unique<juce::dsp::FFT> (order);
+    window.resize (size);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) size, juce::dsp::WindowingFunction<float>::hann);
+    input.resize (size);
+    output.resize (size);
+    fifoFirst.resize (size);
+    fifoSecond.resize (size);
+    reset();
+}
+
+void PairedFft::reset() noexcept
+{
+    std::fill (fifoFirst.begin(), fifoFirst.end(), 0.0f);
+    std::fill (fifoSecond.begin(), fifoSecond.end(), 0.0f);
+    fifoIndex = 0;
+}
+
+void PairedFft::transform() noexcept
+{
+    NEONSCOPE_TRACE_SCOPE ("Paired FFT");
+
+    for (int i = 0; i < size; ++i)
+        input[(size_t) i] = { fifoFirst[(size_t) i] * window[(size_t) i], fifoSecond[(size_t) i] * window[(size_t) i] };
+
+    fft->perform (input.data(), output.data(), false);
+}
+
+size_t PairedFft::getMemoryBytes() const noexcept
+{
+    // The FFT keeps a twiddle table of size complex values next to its workspace.
+    return (window.capacity() + fifoFirst.capacity() + fifoSecond.capacity()) * sizeof (float)
+         + (input.capacity() + output.capacity()) * sizeof (juce::dsp::Complex<float>)
+         + (fft != nullptr ? sizeof (juce::dsp::FFT) + size * sizeof (std::complex<float>) : 0);
+}
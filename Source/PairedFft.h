@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+#include <memory>
+#include <vector>
+
+// The framing both spectrum analysers share: two real signals buffered into
+// 2048-sample frames, Hann-windowed and sent through one complex FFT, the
+// first as the real part and the second as the imaginary part. Their spectra
+// are split apart from the conjugate symmetry of real signals: with
+// Z = FFT (a + j b),
+//
+//     A[k] = (Z[k] + conj (Z[N - k])) / 2
+//     B[k] = (Z[k] - conj (Z[N - k])) / 2j
+//
+// Both are scaled by 1 / N. The window is normalised to a mean of 1, so a
+// sine of amplitude 1 on a bin reads 0.5 there and 0.25 in each neighbour.
+class PairedFft
+{
+public:
+    static constexpr int order = 11;
+    static constexpr int size = 1 << order;
+    static constexpr int numBins = size / 2 + 1;
+
+    // Allocates on the first call only.
+    void prepare();
+    void reset() noexcept;
+    bool isPrepared() const noexcept  { return fft != nullptr; }
+
+    // Feeds both signals into the FIFOs; each is the mean of its left and
+    // right, or left alone where right is null. Every time the FIFOs fill,
+    // the frame is transformed and onFrame() is called, with first() and
+    // second() then holding its spectra.
+    template <typename FrameCallback>
+    void push (const float* firstLeft, const float* firstRight, const float* secondLeft, const float* secondRight,
+               int numSamples, FrameCallback&& onFrame)
+    {
+        int offset = 0;
+
+        while (offset < numSamples)
+        {
+            const int count = juce::jmin (numSamples - offset, size - fifoIndex);
+            mixDown (firstLeft + offset, firstRight != nullptr ? firstRight + offset : nullptr, fifoFirst.data() + fifoIndex, count);
+            mixDown (secondLeft + offset, secondRight != nullptr ? secondRight + offset : nullptr, fifoSecond.data() + fifoIndex, count);
+
+            offset += count;
+            fifoIndex += count;
+
+            if (fifoIndex == size)
+            {
+                fifoIndex = 0;
+                transform();
+                onFrame();
+            }
+        }
+    }
+
+    // Bins 0 to numBins - 1 of the last frame.
+    juce::dsp::Complex<float> first (int bin) const noexcept
+    {
+        const auto z = output[(size_t) bin];
+        const auto mirrored = std::conj (output[(size_t) ((size - bin) & (size - 1))]);
+        return (z + mirrored) * scale;
+    }
+
+    juce::dsp::Complex<float> second (int bin) const noexcept
+    {
+        const auto z = output[(size_t) bin];
+        const auto mirrored = std::conj (output[(size_t) ((size - bin) & (size - 1))]);
+        return juce::dsp::Complex<float> (z.imag() - mirrored.imag(), mirrored.real() - z.real()) * scale;
+    }
+
+    size_t getMemoryBytes() const noexcept;
+
+private:
+    static constexpr float scale = 0.5f / static_cast<float> (size);
+
+    static void mixDown (const float* left, const float* right, float* destination, int count) noexcept
+    {
+        if (right == nullptr)
+        {
+            std::copy (left, left + count, destination);
+            return;
+        }
+
+        for (int i = 0; i < count; ++i)
+            destination[i] = (left[i] + right[i]) * 0.5f;
+    }
+
+    void transform() noexcept;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window;
+    std::vector<juce::dsp::Complex<float>> input, output;
+    std::vector<float> fifoFirst, fifoSecond;
+    int fifoIndex = 0;
+};
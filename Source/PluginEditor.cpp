@@ -1,6 +1,7 @@
 #include "PluginEditor.h"
 
 #include <cmath>
+#include <iterator>
 
 namespace
 {
@@ -8,6 +9,20 @@ namespace
     constexpr float meterDbCeiling = 0.0f;
     constexpr float peakDbCeiling  = 6.0f;
 
+    // Animation runs on elapsed time, so it looks the same at any refresh rate.
+    constexpr float peakHoldSeconds = 0.3f;
+    constexpr float peakHoldFallPerSecond = 0.6f;      // of the meter height
+    constexpr float limiterFlashTimeConstant = 0.033f;
+
+    // With nothing changing for idleAfterSeconds, the editor checks for new
+    // data every idleIntervalSeconds instead of on every display refresh.
+    constexpr double idleAfterSeconds = 0.5;
+    constexpr double idleIntervalSeconds = 0.1;
+
+    // A longer gap (a stall, or the window coming back on screen) is treated
+    // as this long, so decays resume rather than jump.
+    constexpr double maxTickSeconds = 0.25;
+
     static juce::String formatHz (float v)
     {
         if (v >= 1000.0f)
@@ -30,10 +45,41 @@ namespace
         return formatDb (juce::Decibels::gainToDecibels (v, -60.0f));
     }
 
+    static juce::String formatLufs (float v)
+    {
+        return v <= LoudnessMeter::silenceLufs + 1.0f ? juce::String ("--") : juce::String (v, 1);
+    }
+
     static float dbToNorm (float db, float minDb, float maxDb)
     {
         return juce::jlimit (0.0f, 1.0f, juce::jmap (db, minDb, maxDb, 0.0f, 1.0f));
     }
+
+    // Where a level sits on a meter track, shared by drawing and change detection.
+    static float meterLevelY (juce::Rectangle<float> track, float db, float ceilingDb)
+    {
+        return track.getBottom() - track.getHeight() * dbToNorm (db, meterDbFloor, ceilingDb);
+    }
+
+    static float correlationX (juce::Rectangle<float> track, float correlation)
+    {
+        return track.getX() + track.getWidth() * juce::jlimit (0.0f, 1.0f, (correlation + 1.0f) * 0.5f);
+    }
+
+    // Half a logical pixel is one physical pixel on a 2x display; smaller moves
+    // are not worth a repaint.
+    static int halfPixels (float position)  { return juce::roundToInt (position * 2.0f); }
+    static int steps (float value, float perUnit)  { return juce::roundToInt (value * perUnit); }
+
+    // The parameters behind NeonScopeAudioProcessorEditor::WatchedParameter, in order.
+    constexpr const char* watchedParameterIds[] { "cutoff", "resonance", "drive", "mix", "outputTrim", "sensitivity", "mode" };
+
+    static juce::String formatSpan (double seconds)
+    {
+        if (seconds >= 3600.0) return juce::String (seconds / 3600.0, 1) + " h";
+        if (seconds >= 60.0)   return juce::String (seconds / 60.0, 1) + " min";
+        return juce::String (seconds, 0) + " s";
+    }
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -172,6 +218,65 @@ void ScopeLookAndFeel::drawToggleButton (juce::Graphics& g, juce::ToggleButton&
     g.drawText (button.getButtonText(), bounds, juce::Justification::centred);
 }
 
+#if NEONSCOPE_PROFILING
+// ═══════════════════════════════════════════════════════════════════════════════
+//  PerformanceOverlay
+// ═══════════════════════════════════════════════════════════════════════════════
+
+PerformanceOverlay::PerformanceOverlay (StageProfiler& p)
+    : profiler (p)
+{
+    setInterceptsMouseClicks (false, false);
+}
+
+void PerformanceOverlay::refresh()
+{
+    stats = profiler.collect (previous);
+    repaint();
+}
+
+void PerformanceOverlay::paint (juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour (Theme::background.withAlpha (0.92f));
+    g.fillRoundedRectangle (bounds, Theme::cornerRadius);
+    g.setColour (Theme::borderLight);
+    g.drawRoundedRectangle (bounds, Theme::cornerRadius, 1.0f);
+
+    auto content = bounds.reduced (14.0f, 10.0f);
+    const float rowH = juce::jmin (18.0f, content.getHeight() / (float) (StageProfiler::numStages + 1));
+    const float colW = (content.getWidth() - 110.0f) / 4.0f;
+
+    auto drawRow = [&] (juce::Rectangle<float> row, const juce::String& name,
+                        const juce::StringArray& values, juce::Colour colour)
+    {
+        g.setColour (colour);
+        g.drawText (name, row.removeFromLeft (110.0f), juce::Justification::centredLeft);
+        for (auto& v : values)
+            g.drawText (v, row.removeFromLeft (colW), juce::Justification::centredRight);
+    };
+
+    g.setFont (juce::Font (Theme::labelSize, juce::Font::bold));
+    drawRow (content.removeFromTop (rowH), "Stage",
+             { "Mean us", "p99 us", "Max us", "Budget" }, Theme::textSecondary);
+
+    g.setFont (juce::Font (Theme::valueSize));
+    for (int stage = 0; stage < StageProfiler::numStages; ++stage)
+    {
+        const auto& s = stats[(size_t) stage];
+        const bool isTotal = stage == StageProfiler::total;
+
+        drawRow (content.removeFromTop (rowH), StageProfiler::getStageName (stage),
+                 { juce::String (s.meanMicroseconds, 1),
+                   juce::String (s.p99Microseconds, 1),
+                   juce::String (s.maxMicroseconds, 1),
+                   juce::String (s.budgetPercent, 2) + "%" },
+                 s.blocks == 0 ? Theme::textSecondary.withAlpha (0.5f)
+                               : (isTotal ? Theme::accent : Theme::textPrimary));
+    }
+}
+#endif
+
 // ═══════════════════════════════════════════════════════════════════════════════
 //  Editor — Construction
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -191,22 +296,75 @@ void NeonScopeAudioProcessorEditor::configureKnob (juce::Slider& slider,
     label.setFont (juce::Font (Theme::labelSize));
 }
 
-void NeonScopeAudioProcessorEditor::refreshKnobLabels()
+// Reads the parameters rather than the sliders, which their attachments may
+// not have caught up yet.
+void NeonScopeAudioProcessorEditor::refreshKnobLabels (juce::uint32 changed)
+{
+    auto set = [this, changed] (WatchedParameter parameter, juce::Label& l, const juce::String& title,
+                                juce::String (*format) (float))
+    {
+        if ((changed & (1u << parameter)) != 0)
+            l.setText (title + "\n" + format (watchedValues[(size_t) parameter]->load()), juce::dontSendNotification);
+    };
+    set (cutoffParameter, cutoffLabel, "Cutoff", formatHz);
+    set (resonanceParameter, resonanceLabel, "Q", formatQ);
+    set (driveParameter, driveLabel, "Drive", formatDrive);
+    set (mixParameter, mixLabel, "Mix", formatPercent);
+    set (outputParameter, outputLabel, "Output", formatDb);
+    set (sensitivityParameter, sensitivityLabel, "Sensitivity", formatSensitivity);
+}
+
+void NeonScopeAudioProcessorEditor::refreshModeState()
 {
-    auto set = [] (juce::Label& l, const juce::String& title, const juce::String& value)
+    const int modeVal = juce::roundToInt (watchedValues[modeParameter]->load());
+    const bool processing = modeVal != 0;
+    const bool filterOn   = modeVal == 1 || modeVal == 3;
+    const bool distOn     = modeVal == 2 || modeVal == 3;
+
+    auto setActive = [] (juce::Component& c, bool on)
     {
-        l.setText (title + "\n" + value, juce::dontSendNotification);
+        c.setEnabled (on);
+        c.setAlpha (on ? 1.0f : 0.35f);
     };
-    set (cutoffLabel, "Cutoff", formatHz ((float) cutoffSlider.getValue()));
-    set (resonanceLabel, "Q", formatQ ((float) resonanceSlider.getValue()));
-    set (driveLabel, "Drive", formatDrive ((float) driveSlider.getValue()));
-    set (mixLabel, "Mix", formatPercent ((float) mixSlider.getValue()));
-    set (outputLabel, "Output", formatDb ((float) outputSlider.getValue()));
-    set (sensitivityLabel, "Sensitivity", formatSensitivity ((float) sensitivitySlider.getValue()));
+    auto setKnob = [] (juce::Slider& s, juce::Label& l, bool on)
+    {
+        s.setEnabled (on); l.setEnabled (on);
+        s.setAlpha (on ? 1.0f : 0.3f);
+        l.setAlpha (on ? 1.0f : 0.3f);
+    };
+
+    setActive (filterTypeBox, filterOn);
+    setKnob (cutoffSlider, cutoffLabel, filterOn);
+    setKnob (resonanceSlider, resonanceLabel, filterOn);
+    setKnob (driveSlider, driveLabel, distOn);
+    setActive (satModeBox, distOn);
+    setActive (oversamplingBox, distOn);
+    setKnob (mixSlider, mixLabel, distOn);
+    setKnob (outputSlider, outputLabel, processing);
+    setKnob (sensitivitySlider, sensitivityLabel, true);
+
+    autoGainButton.setAlpha (distOn ? 1.0f : 0.4f);
+    limiterButton.setAlpha (processing ? 1.0f : 0.6f);
+    bandListenButton.setAlpha (filterOn ? 1.0f : 0.35f);
+    autoGainValueLabel.setAlpha (distOn ? 1.0f : 0.4f);
+}
+
+// Title bar controls that only apply to the current view. Smoothing acts on
+// the curve, which filterbank mode replaces with bars.
+void NeonScopeAudioProcessorEditor::refreshViewControls()
+{
+    const bool filterbank = bandAnalysisBox.getSelectedId() == 2;
+
+    bandAnalysisBox.setVisible (view == View::spectrum);
+    smoothingBox.setVisible (view == View::spectrum && ! filterbank);
+    scopeTriggerBox.setVisible (view == View::oscilloscope);
 }
 
 NeonScopeAudioProcessorEditor::NeonScopeAudioProcessorEditor (NeonScopeAudioProcessor& p)
     : juce::AudioProcessorEditor (&p), processor (p)
+   #if NEONSCOPE_PROFILING
+    , perfOverlay (p.getProfiler())
+   #endif
 {
     setLookAndFeel (&scopeLnf);
 
@@ -233,6 +391,11 @@ NeonScopeAudioProcessorEditor::NeonScopeAudioProcessorEditor (NeonScopeAudioProc
     configureCombo (satModeBox);
     configureCombo (oversamplingBox);
     configureCombo (monitorModeBox);
+    configureCombo (referenceModeBox);
+    configureCombo (viewBox);
+    configureCombo (bandAnalysisBox);
+    configureCombo (smoothingBox);
+    configureCombo (scopeTriggerBox);
 
     modeBox.addItem ("Visualize Only", 1);
     modeBox.addItem ("Tone Filter", 2);
@@ -263,13 +426,49 @@ NeonScopeAudioProcessorEditor::NeonScopeAudioProcessorEditor (NeonScopeAudioProc
     monitorModeBox.addItem ("Mid", 5);
     monitorModeBox.addItem ("Side", 6);
 
+    referenceModeBox.addItem ("Ref Off", 1);
+    referenceModeBox.addItem ("Overlay", 2);
+    referenceModeBox.addItem ("Audition", 3);
+
+    viewBox.addItem ("Spectrum", (int) View::spectrum);
+    viewBox.addItem ("History", (int) View::history);
+    viewBox.addItem ("Spectrogram", (int) View::spectrogram);
+    viewBox.addItem ("Goniometer", (int) View::goniometer);
+    viewBox.addItem ("Oscilloscope", (int) View::oscilloscope);
+
+    bandAnalysisBox.addItem ("FFT bands", 1);
+    bandAnalysisBox.addItem ("Filterbank", 2);
+
+    smoothingBox.addItem ("No smoothing", (int) SpectrumCurve::Smoothing::off);
+    smoothingBox.addItem ("1/12 oct", (int) SpectrumCurve::Smoothing::twelfthOctave);
+    smoothingBox.addItem ("1/6 oct", (int) SpectrumCurve::Smoothing::sixthOctave);
+    smoothingBox.addItem ("1/3 oct", (int) SpectrumCurve::Smoothing::thirdOctave);
+
+    scopeTriggerBox.addItem ("Free run", (int) Oscilloscope::Trigger::freeRun);
+    scopeTriggerBox.addItem ("Rising edge", (int) Oscilloscope::Trigger::rising);
+    scopeTriggerBox.addItem ("Falling edge", (int) Oscilloscope::Trigger::falling);
+    scopeTriggerBox.addItem ("Tempo sync", (int) Oscilloscope::Trigger::tempo);
+
+    juce::ColourGradient heat (Theme::background, 0.0f, 0.0f, juce::Colours::white, 1.0f, 0.0f, false);
+    heat.addColour (0.35, Theme::accentDim.withMultipliedBrightness (0.6f));
+    heat.addColour (0.65, Theme::accent);
+    heat.addColour (0.85, juce::Colour (0xffFFE45C));
+
+    for (size_t i = 0; i < spectrogramColours.size(); ++i)
+    {
+        const auto colour = heat.getColourAtPosition ((double) i / (double) (spectrogramColours.size() - 1));
+        spectrogramColours[i].setARGB (255, colour.getRed(), colour.getGreen(), colour.getBlue());
+    }
+
+    goniometer.setColours (Theme::background, Theme::accent);
+
     for (auto* c : std::initializer_list<juce::Component*> {
              &modeBox, &filterTypeBox, &satModeBox, &oversamplingBox, &monitorModeBox,
              &cutoffSlider, &cutoffLabel, &resonanceSlider, &resonanceLabel,
              &driveSlider, &driveLabel, &mixSlider, &mixLabel,
              &outputSlider, &outputLabel, &sensitivitySlider, &sensitivityLabel,
              &autoGainButton, &limiterButton, &bandListenButton,
-             &autoGainValueLabel, &monitorModeLabel })
+             &autoGainValueLabel, &monitorModeLabel, &referenceButton, &referenceModeBox, &viewBox, &bandAnalysisBox, &smoothingBox, &scopeTriggerBox })
         addAndMakeVisible (c);
 
     auto& vts = processor.getValueTreeState();
@@ -278,6 +477,8 @@ NeonScopeAudioProcessorEditor::NeonScopeAudioProcessorEditor (NeonScopeAudioProc
     satModeAttachment     = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (vts, "satMode", satModeBox);
     oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (vts, "oversampling", oversamplingBox);
     monitorModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (vts, "monitorMode", monitorModeBox);
+    referenceModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (vts, "referenceMode", referenceModeBox);
+    bandAnalysisAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (vts, "bandAnalysis", bandAnalysisBox);
     cutoffAttachment      = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (vts, "cutoff", cutoffSlider);
     driveAttachment       = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (vts, "drive", driveSlider);
     resonanceAttachment   = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (vts, "resonance", resonanceSlider);
@@ -288,6 +489,14 @@ NeonScopeAudioProcessorEditor::NeonScopeAudioProcessorEditor (NeonScopeAudioProc
     limiterAttachment     = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (vts, "SAFETY_LIMITER", limiterButton);
     bandListenAttachment  = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (vts, "bandListen", bandListenButton);
 
+    static_assert (std::size (watchedParameterIds) == numWatchedParameters);
+    for (size_t i = 0; i < watchedValues.size(); ++i)
+    {
+        watchedValues[i] = vts.getRawParameterValue (watchedParameterIds[i]);
+        jassert (watchedValues[i] != nullptr);
+        vts.addParameterListener (watchedParameterIds[i], this);
+    }
+
     autoGainValueLabel.setJustificationType (juce::Justification::centred);
     autoGainValueLabel.setColour (juce::Label::textColourId, Theme::textSecondary);
     autoGainValueLabel.setFont (juce::Font (Theme::valueSize, juce::Font::bold));
@@ -300,17 +509,111 @@ NeonScopeAudioProcessorEditor::NeonScopeAudioProcessorEditor (NeonScopeAudioProc
     monitorModeLabel.setFont (juce::Font (Theme::labelSize));
     monitorModeLabel.setInterceptsMouseClicks (false, false);
 
-    setSize (760, 540);
-    startTimerHz (60);
-    refreshKnobLabels();
+    referenceButton.setColour (juce::TextButton::buttonColourId, Theme::panel);
+    referenceButton.setColour (juce::TextButton::textColourOffId, Theme::reference);
+    referenceButton.onClick = [this] { chooseReferenceFile(); };
+
+    // The chosen view is kept with the session, next to the reference path.
+    auto& state = processor.getValueTreeState().state;
+    const int storedView = state.getProperty ("view", (int) View::spectrum);
+    view = storedView >= (int) View::spectrum && storedView <= (int) View::oscilloscope ? static_cast<View> (storedView)
+                                                                                          : View::spectrum;
+    viewBox.setSelectedId ((int) view, juce::dontSendNotification);
+    refreshViewControls();
+    viewBox.onChange = [this]
+    {
+        view = static_cast<View> (viewBox.getSelectedId());
+        processor.getValueTreeState().state.setProperty ("view", (int) view, nullptr);
+        refreshViewControls();
+
+        if (view == View::spectrum)
+            spectrumCurve.update (spectrumFrame);
+
+        updateVisualState();
+        repaint();
+    };
+
+    // The attachment listens to the box itself, so onChange is free for this.
+    bandAnalysisBox.onChange = [this] { refreshViewControls(); };
+
+    const int storedSmoothing = state.getProperty ("spectrumSmoothing", (int) SpectrumCurve::Smoothing::off);
+    spectrumCurve.setSmoothing (storedSmoothing >= (int) SpectrumCurve::Smoothing::off
+                                    && storedSmoothing <= (int) SpectrumCurve::Smoothing::thirdOctave
+                                ? static_cast<SpectrumCurve::Smoothing> (storedSmoothing)
+                                : SpectrumCurve::Smoothing::off);
+    smoothingBox.setSelectedId ((int) spectrumCurve.getSmoothing(), juce::dontSendNotification);
+    smoothingBox.onChange = [this]
+    {
+        spectrumCurve.setSmoothing (static_cast<SpectrumCurve::Smoothing> (smoothingBox.getSelectedId()));
+        processor.getValueTreeState().state.setProperty ("spectrumSmoothing", smoothingBox.getSelectedId(), nullptr);
+        spectrumCurve.update (spectrumFrame);
+        repaint();
+    };
+
+    const int storedTrigger = state.getProperty ("scopeTrigger", (int) Oscilloscope::Trigger::rising);
+    oscilloscope.setTrigger (storedTrigger >= (int) Oscilloscope::Trigger::freeRun && storedTrigger <= (int) Oscilloscope::Trigger::tempo
+                                 ? static_cast<Oscilloscope::Trigger> (storedTrigger)
+                                 : Oscilloscope::Trigger::rising);
+    oscilloscope.setTimebase (state.getProperty ("scopeTimebase", oscilloscope.getTimebase()));
+    scopeTriggerBox.setSelectedId ((int) oscilloscope.getTrigger(), juce::dontSendNotification);
+    scopeTriggerBox.onChange = [this]
+    {
+        oscilloscope.setTrigger (static_cast<Oscilloscope::Trigger> (scopeTriggerBox.getSelectedId()));
+        processor.getValueTreeState().state.setProperty ("scopeTrigger", scopeTriggerBox.getSelectedId(), nullptr);
+        updateVisualState();
+        repaint();
+    };
+
+   #if NEONSCOPE_PROFILING
+    addAndMakeVisible (perfButton);
+    addChildComponent (perfOverlay);
+    perfButton.onClick = [this]
+    {
+        perfOverlay.setVisible (perfButton.getToggleState());
+        perfOverlay.toFront (false);
+        perfRefreshSeconds = 0.0;
+    };
+   #endif
+
+    // paint() covers every pixel, so nothing behind the editor needs drawing.
+    setOpaque (true);
+    setSize (760, 680);
+    refreshKnobLabels (allWatchedParameters);
+    refreshModeState();
     updateVisualState();
 }
 
 NeonScopeAudioProcessorEditor::~NeonScopeAudioProcessorEditor()
 {
+    for (const auto* parameterID : watchedParameterIds)
+        processor.getValueTreeState().removeParameterListener (parameterID, this);
+
+    cancelPendingUpdate();
     setLookAndFeel (nullptr);
 }
 
+void NeonScopeAudioProcessorEditor::chooseReferenceFile()
+{
+    juce::PopupMenu menu;
+    menu.addItem ("Load reference...", [this]
+    {
+        referenceChooser = std::make_unique<juce::FileChooser> ("Choose a reference track", juce::File(),
+                                                                "*.wav;*.aif;*.aiff;*.flac;*.ogg;*.mp3");
+        referenceChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                       [this] (const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+
+            if (file.existsAsFile())
+                processor.loadReference (file);
+        });
+    });
+    menu.addItem ("Clear reference", processor.getReferenceTrack().getStatus() != ReferenceTrack::Status::empty,
+                  false, [this] { processor.clearReference(); });
+
+    menu.showMenuAsync (juce::PopupMenu::Options().withTargetComponent (referenceButton));
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 //  Editor — Drawing Helpers
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -339,178 +642,515 @@ void NeonScopeAudioProcessorEditor::drawPanel (juce::Graphics& g,
     }
 }
 
-void NeonScopeAudioProcessorEditor::drawSpectrum (juce::Graphics& g)
+// The panel frame is part of the cached chrome; only the view is drawn here.
+void NeonScopeAudioProcessorEditor::drawDisplayPanel (juce::Graphics& g)
 {
-    if (spectrumBounds.isEmpty()) return;
+    if (spectrumBounds.isEmpty() || ! g.clipRegionIntersects (spectrumBounds.getSmallestIntegerContainer())) return;
 
-    g.setColour (Theme::panel);
-    g.fillRoundedRectangle (spectrumBounds, Theme::cornerRadius);
-    g.setColour (Theme::border);
-    g.drawRoundedRectangle (spectrumBounds, Theme::cornerRadius, 1.0f);
+    switch (view)
+    {
+        case View::spectrum:     drawSpectrum (g, displayBounds); break;
+        case View::history:      drawHistory (g, displayBounds); break;
+        case View::spectrogram:  drawSpectrogram (g, displayBounds); break;
+        case View::goniometer:   drawGoniometer (g, displayBounds); break;
+        case View::oscilloscope: drawOscilloscope (g, displayBounds); break;
+    }
+}
 
-    auto area = spectrumBounds.reduced (12.0f, 8.0f);
-    const float barW = area.getWidth() / (float) NeonScopeAudioProcessor::numBands;
-    const float gap = 4.0f;
+// The curve's paths are rebuilt when a frame arrives, so painting it is one
+// fill and one stroke of a path with a vertex per pixel column. In filterbank
+// mode the bands are drawn as bars instead, since they move faster than the
+// curve can; like the meters, they go into a raster layer when there is one.
+void NeonScopeAudioProcessorEditor::drawSpectrum (juce::Graphics& g, juce::Rectangle<float> area)
+{
+    const float bandWidth = area.getWidth() / (float) NeonScopeAudioProcessor::numBands;
 
-    for (int i = 0; i < NeonScopeAudioProcessor::numBands; ++i)
+    if (bandFilterbank)
     {
-        const float val = juce::jlimit (0.0f, 1.0f, bandCache[(size_t) i]);
-        const float h = juce::jmax (2.0f, area.getHeight() * val);
+        const float gap = 4.0f;
+        const bool toLayer = bandBarsLayer.isReady();
+
+        if (toLayer)
+            bandBarsLayer.begin();
+
+        for (int i = 0; i < NeonScopeAudioProcessor::numBands; ++i)
+        {
+            const float val = juce::jlimit (0.0f, 1.0f, bandCache[(size_t) i]);
+            const float h = juce::jmax (2.0f, area.getHeight() * val);
+
+            juce::Rectangle<float> bar {
+                area.getX() + i * bandWidth + gap * 0.5f,
+                area.getBottom() - h,
+                juce::jmax (1.0f, bandWidth - gap),
+                h
+            };
+
+            const auto colour = Theme::accent.withAlpha (0.15f + val * 0.55f);
+
+            if (toLayer)
+            {
+                bandBarsLayer.fillRoundedRect (bar, 2.0f, colour);
+            }
+            else
+            {
+                g.setColour (colour);
+                g.fillRoundedRectangle (bar, 2.0f);
+            }
+        }
+
+        if (toLayer)
+            bandBarsLayer.blit (g);
+    }
+    else
+    {
+        g.setGradientFill (juce::ColourGradient (Theme::accent.withAlpha (0.45f), 0.0f, area.getY(),
+                                                 Theme::accent.withAlpha (0.05f), 0.0f, area.getBottom(), false));
+        g.fillPath (spectrumCurve.getFill());
 
-        juce::Rectangle<float> bar {
-            area.getX() + i * barW + gap * 0.5f,
-            area.getBottom() - h,
-            juce::jmax (1.0f, barW - gap),
-            h
-        };
+        g.setColour (Theme::accent);
+        g.strokePath (spectrumCurve.getOutline(), juce::PathStrokeType (1.5f));
+    }
+
+    // Band levels as a line through the band centres on the same log axis
+    auto strokeBands = [&] (const std::array<float, NeonScopeAudioProcessor::numBands>& levels, juce::Colour colour)
+    {
+        juce::Path line;
 
-        g.setColour (Theme::accent.withAlpha (0.15f + val * 0.55f));
-        g.fillRoundedRectangle (bar, 2.0f);
+        for (int i = 0; i < NeonScopeAudioProcessor::numBands; ++i)
+        {
+            const float val = juce::jlimit (0.0f, 1.0f, levels[(size_t) i]);
+            const juce::Point<float> point { area.getX() + (i + 0.5f) * bandWidth, area.getBottom() - area.getHeight() * val };
+
+            if (i == 0)
+                line.startNewSubPath (point);
+            else
+                line.lineTo (point);
+        }
+
+        g.setColour (colour.withAlpha (0.85f));
+        g.strokePath (line, juce::PathStrokeType (1.5f, juce::PathStrokeType::curved, juce::PathStrokeType::rounded));
+    };
+
+    if (referenceActive)
+        strokeBands (referenceBandCache, Theme::reference);
+
+    // The sidechain key, and along the bottom edge how much of each band it masks.
+    if (sidechainActive)
+    {
+        strokeBands (sidechainBandCache, Theme::sidechain);
+
+        for (int i = 0; i < NeonScopeAudioProcessor::numBands; ++i)
+        {
+            const float masking = juce::jlimit (0.0f, 1.0f, sidechainMaskingCache[(size_t) i]);
+            g.setColour (Theme::danger.withAlpha (0.8f * masking));
+            g.fillRect (area.getX() + (float) i * bandWidth + 1.0f, area.getBottom() - 4.0f, bandWidth - 2.0f, 4.0f);
+        }
     }
 }
 
-void NeonScopeAudioProcessorEditor::drawSingleMeter (juce::Graphics& g,
-                                                       juce::Rectangle<float> area,
-                                                       float rmsDb, float peakDb,
-                                                       float holdNorm,
-                                                       const juce::String& label)
+// One pixel column per summary column: the level range as a bar, with the mean
+// level and momentary loudness as lines through it.
+void NeonScopeAudioProcessorEditor::drawHistory (juce::Graphics& g, juce::Rectangle<float> area)
 {
     if (area.isEmpty()) return;
 
-    // Label
-    auto labelArea = area.removeFromTop (18.0f);
+    const auto toY = [area] (float db)
+    {
+        return area.getBottom() - area.getHeight() * dbToNorm (db, meterDbFloor, peakDbCeiling);
+    };
+
+    g.setColour (Theme::border.withAlpha (0.6f));
+    for (auto tick : processor.getMeterTicks())
+        g.drawHorizontalLine (juce::roundToInt (toY (tick)), area.getX(), area.getRight());
+
+    juce::Path levelLine, loudnessLine;
+    bool levelDrawing = false, loudnessDrawing = false;
+
+    // Lines break across gaps rather than joining them.
+    const auto extend = [] (juce::Path& path, bool& drawing, bool valid, float x, float y)
+    {
+        if (! valid)
+            drawing = false;
+        else if (drawing)
+            path.lineTo (x, y);
+        else
+            path.startNewSubPath (x, y);
+
+        drawing = drawing || valid;
+    };
+
+    g.setColour (Theme::accent.withAlpha (0.3f));
+
+    for (size_t i = 0; i < levelColumns.size(); ++i)
+    {
+        const auto& level = levelColumns[i];
+        const auto& loudness = loudnessColumns[i];
+        const float x = area.getX() + (float) i;
+
+        if (level.valid)
+        {
+            const float top = toY (level.max);
+            g.fillRect (x, top, 1.0f, juce::jmax (1.0f, toY (level.min) - top));
+        }
+
+        extend (levelLine, levelDrawing, level.valid, x, toY (level.mean));
+        extend (loudnessLine, loudnessDrawing, loudness.valid && loudness.mean > meterDbFloor, x, toY (loudness.mean));
+    }
+
+    g.setColour (Theme::accent);
+    g.strokePath (levelLine, juce::PathStrokeType (1.2f));
+    g.setColour (Theme::textPrimary.withAlpha (0.7f));
+    g.strokePath (loudnessLine, juce::PathStrokeType (1.2f));
+
     g.setColour (Theme::textSecondary);
-    g.setFont (juce::Font (Theme::labelSize));
-    g.drawText (label, labelArea, juce::Justification::centred);
+    g.setFont (labelFont);
+    g.drawText ("Last " + formatSpan (historySpanSeconds) + "  |  RMS, peak, momentary LUFS",
+                area.removeFromTop (14.0f), juce::Justification::centredLeft);
+}
+
+// The image is never scrolled: the oldest columns, from the write position to
+// the right edge, are drawn first, then the newest from the left edge.
+void NeonScopeAudioProcessorEditor::drawSpectrogram (juce::Graphics& g, juce::Rectangle<float> area)
+{
+    if (! spectrogramImage.isValid()) return;
+
+    const auto dest = area.toNearestInt();
+    const int width = spectrogramImage.getWidth();
+    const int height = spectrogramImage.getHeight();
+    const int oldestWidth = width - spectrogramWriteX;
+
+    g.drawImage (spectrogramImage, dest.getX(), dest.getY(), oldestWidth, height,
+                 spectrogramWriteX, 0, oldestWidth, height);
+
+    if (spectrogramWriteX > 0)
+        g.drawImage (spectrogramImage, dest.getX() + oldestWidth, dest.getY(), spectrogramWriteX, height,
+                     0, 0, spectrogramWriteX, height);
+
+    g.setColour (Theme::textSecondary);
+    g.setFont (labelFont);
+    g.drawText ("20 kHz", area.removeFromTop (14.0f), juce::Justification::centredLeft);
+    g.drawText ("20 Hz", area.removeFromBottom (14.0f), juce::Justification::centredLeft);
+}
+
+// O(height): one colour lookup per image row, written straight into the bitmap.
+void NeonScopeAudioProcessorEditor::writeSpectrogramColumn (const AnalysisEngine::SpectrumColumn& column)
+{
+    if (! spectrogramImage.isValid()) return;
+
+    juce::Image::BitmapData pixels (spectrogramImage, spectrogramWriteX, 0, 1, spectrogramImage.getHeight(),
+                                    juce::Image::BitmapData::writeOnly);
+
+    for (int y = 0; y < pixels.height; ++y)
+        reinterpret_cast<juce::PixelRGB*> (pixels.getLinePointer (y))->set (spectrogramColours[column[(size_t) spectrogramRows[(size_t) y]]]);
+
+    spectrogramWriteX = (spectrogramWriteX + 1) % spectrogramImage.getWidth();
+}
+
+// A square in the middle of the strip, with the L, R, mid and side axes over
+// the trace, the correlation of each band to its left and the overall
+// correlation and width readings to its right.
+void NeonScopeAudioProcessorEditor::drawGoniometer (juce::Graphics& g, juce::Rectangle<float> area)
+{
+    const auto& image = goniometer.getImage();
+    if (! image.isValid()) return;
+
+    const auto square = area.withSizeKeepingCentre ((float) image.getWidth(), (float) image.getHeight()).toNearestInt();
+    g.drawImageAt (image, square.getX(), square.getY());
+
+    const auto bounds = square.toFloat();
+    const auto centre = bounds.getCentre();
+    g.setColour (Theme::border.withAlpha (0.6f));
+    g.drawLine (bounds.getX(), bounds.getY(), bounds.getRight(), bounds.getBottom(), 0.5f);
+    g.drawLine (bounds.getRight(), bounds.getY(), bounds.getX(), bounds.getBottom(), 0.5f);
+    g.drawLine (centre.x, bounds.getY(), centre.x, bounds.getBottom(), 0.5f);
+    g.drawLine (bounds.getX(), centre.y, bounds.getRight(), centre.y, 0.5f);
+
+    g.setColour (Theme::textSecondary);
+    g.setFont (labelFont);
+    const auto labels = bounds.reduced (4.0f, 2.0f);
+    g.drawText ("L", labels, juce::Justification::topLeft);
+    g.drawText ("R", labels, juce::Justification::topRight);
+    g.drawText ("M", labels.withTrimmedLeft (labels.getWidth() * 0.5f + 4.0f), juce::Justification::topLeft);
+    g.drawText ("S", labels.withTrimmedTop (labels.getHeight() * 0.5f + 2.0f), juce::Justification::topLeft);
+
+    auto readings = area.withLeft (bounds.getRight() + 16.0f).removeFromTop (32.0f);
+    g.drawText ("Correlation " + juce::String (correlationValue, 2), readings.removeFromTop (16.0f), juce::Justification::centredLeft);
+    g.drawText ("Width " + juce::String (widthValue, 2), readings, juce::Justification::centredLeft);
+
+    // One bar per band, up from the centre line for in-phase material and
+    // down for out-of-phase, lowest band on the left.
+    auto byBand = area.withRight (bounds.getX() - 16.0f).reduced (14.0f, 4.0f);
+    if (byBand.getWidth() < (float) NeonScopeAudioProcessor::numBands * 3.0f) return;
+
+    g.drawText ("Correlation by band", byBand.removeFromTop (16.0f), juce::Justification::centredLeft);
+    const float columnWidth = byBand.getWidth() / (float) NeonScopeAudioProcessor::numBands;
+    const float halfHeight = byBand.getHeight() * 0.5f;
+
+    g.setColour (Theme::border.withAlpha (0.6f));
+    g.drawLine (byBand.getX(), byBand.getCentreY(), byBand.getRight(), byBand.getCentreY(), 0.5f);
+
+    for (int band = 0; band < NeonScopeAudioProcessor::numBands; ++band)
+    {
+        const float correlation = juce::jlimit (-1.0f, 1.0f, bandCorrelations[(size_t) band]);
+        const float height = std::abs (correlation) * halfHeight;
+        const float x = byBand.getX() + (float) band * columnWidth;
+
+        g.setColour (correlation >= 0.0f ? Theme::accent.withAlpha (0.8f) : Theme::danger.withAlpha (0.8f));
+        g.fillRect (x + 1.0f, correlation >= 0.0f ? byBand.getCentreY() - height : byBand.getCentreY(),
+                    columnWidth - 2.0f, height);
+    }
+}
+
+// The trace is one closed path per redraw: the column maxima left to right
+// and the minima back, so a quiet signal is a line and a dense one a band.
+void NeonScopeAudioProcessorEditor::drawOscilloscope (juce::Graphics& g, juce::Rectangle<float> area)
+{
+    g.setColour (Theme::border.withAlpha (0.6f));
+    g.drawLine (area.getX(), area.getCentreY(), area.getRight(), area.getCentreY(), 0.5f);
+
+    g.setColour (Theme::accent.withAlpha (0.45f));
+    g.fillPath (oscilloscope.getTrace());
+    g.setColour (Theme::accent);
+    g.strokePath (oscilloscope.getTrace(), juce::PathStrokeType (1.0f));
+
+    const double beats = oscilloscope.getWindowBeats();
+    const double seconds = oscilloscope.getWindowSeconds();
+    const auto window = beats > 0.0 ? (beats < 1.0 ? "1/" + juce::String (juce::roundToInt (1.0 / beats)) : juce::String (juce::roundToInt (beats)))
+                                          + (beats == 1.0 ? " beat" : " beats")
+                                    : seconds < 1.0 ? juce::String (seconds * 1000.0, seconds < 0.01 ? 1 : 0) + " ms"
+                                                    : juce::String (seconds, 1) + " s";
 
-    // Value readout
-    auto readout = area.removeFromBottom (16.0f);
-    g.setFont (juce::Font (10.0f));
     g.setColour (Theme::textSecondary);
-    g.drawText (juce::String (rmsDb, 1) + " dB", readout, juce::Justification::centred);
+    g.setFont (labelFont);
+    const auto state = oscilloscope.getTrigger() == Oscilloscope::Trigger::freeRun ? juce::String()
+                     : oscilloscope.isTriggered() ? juce::String ("  Trig'd") : juce::String ("  Auto");
+    g.drawText (window + state, area.reduced (6.0f, 4.0f), juce::Justification::topRight);
+}
+
+// The meter, correlation and loudness parts are each split in two: the chrome,
+// drawn once into the background image, and the values drawn over it.
+void NeonScopeAudioProcessorEditor::drawMeterChrome (juce::Graphics& g, const MeterLayout& meter, const juce::String& label)
+{
+    if (meter.bounds.isEmpty()) return;
 
-    auto meterArea = area.reduced (0.0f, 4.0f);
-    auto inner = meterArea.withSizeKeepingCentre (juce::jmin (14.0f, meterArea.getWidth()), meterArea.getHeight());
+    g.setColour (Theme::textSecondary);
+    g.setFont (juce::Font (Theme::labelSize));
+    g.drawText (label, meter.label, juce::Justification::centred);
 
     // Background track
+    const auto& inner = meter.track;
     g.setColour (Theme::knobFace);
     g.fillRoundedRectangle (inner, 3.0f);
     g.setColour (Theme::border);
     g.drawRoundedRectangle (inner, 3.0f, 0.5f);
 
-    // RMS fill
-    const float rmsNorm = dbToNorm (rmsDb, meterDbFloor, meterDbCeiling);
-    const float fillH = inner.getHeight() * rmsNorm;
-    auto fillRect = inner.withTop (inner.getBottom() - fillH);
-    g.setColour (Theme::accent.withAlpha (0.8f));
-    g.fillRoundedRectangle (fillRect, 2.0f);
+    // Tick marks
+    g.setColour (Theme::border);
+    for (auto db : { 0.0f, -6.0f, -12.0f, -30.0f, -60.0f })
+    {
+        const float ty = meterLevelY (inner, db, meterDbCeiling);
+        g.drawLine (inner.getRight() + 2.0f, ty, inner.getRight() + 6.0f, ty, 0.5f);
+    }
+}
 
-    // Peak line
-    const float peakNorm = dbToNorm (peakDb, meterDbFloor, peakDbCeiling);
-    const float peakY = inner.getBottom() - inner.getHeight() * peakNorm;
-    g.setColour (Theme::textPrimary.withAlpha (0.7f));
-    g.drawLine (inner.getX(), peakY, inner.getRight(), peakY, 1.0f);
+// The shapes go into the meter's raster layer when it has one, and through
+// Graphics otherwise; both draw the same geometry.
+void NeonScopeAudioProcessorEditor::drawSingleMeter (juce::Graphics& g, const MeterLayout& meter, RasterLayer& layer,
+                                                       float rmsDb, float peakDb,
+                                                       float holdNorm, float referenceDb)
+{
+    if (meter.bounds.isEmpty() || ! g.clipRegionIntersects (meter.bounds.getSmallestIntegerContainer())) return;
 
-    // Peak hold dot
+    const auto& inner = meter.track;
+    const auto fillRect = inner.withTop (meterLevelY (inner, rmsDb, meterDbCeiling));
+    const float peakY = meterLevelY (inner, peakDb, peakDbCeiling);
     const float holdY = inner.getBottom() - inner.getHeight() * juce::jlimit (0.0f, 1.0f, holdNorm);
-    g.setColour (Theme::accent);
-    g.fillEllipse ({ inner.getCentreX() - 3.0f, holdY - 3.0f, 6.0f, 6.0f });
+    const float refY = meterLevelY (inner, referenceDb, meterDbCeiling);
 
-    // Tick marks
-    g.setFont (juce::Font (9.0f));
-    for (auto db : { 0.0f, -6.0f, -12.0f, -30.0f, -60.0f })
+    if (layer.isReady())
     {
-        const float n = dbToNorm (db, meterDbFloor, meterDbCeiling);
-        const float ty = inner.getBottom() - inner.getHeight() * n;
-        g.setColour (Theme::border);
-        g.drawLine (inner.getRight() + 2.0f, ty, inner.getRight() + 6.0f, ty, 0.5f);
+        layer.begin();
+        layer.fillRoundedRect (fillRect, 2.0f, Theme::accent.withAlpha (0.8f));
+        layer.fillRect ({ inner.getX(), peakY - 0.5f, inner.getWidth(), 1.0f }, Theme::textPrimary.withAlpha (0.7f));
+        layer.fillDisc ({ inner.getCentreX(), holdY }, 6.0f, Theme::accent);
+
+        if (referenceActive)
+            layer.fillArrow ({ inner.getX() - 1.0f, refY }, 6.0f, 4.0f, Theme::reference);
+
+        layer.blit (g);
+    }
+    else
+    {
+        // RMS fill
+        g.setColour (Theme::accent.withAlpha (0.8f));
+        g.fillRoundedRectangle (fillRect, 2.0f);
+
+        // Peak line
+        g.setColour (Theme::textPrimary.withAlpha (0.7f));
+        g.drawLine (inner.getX(), peakY, inner.getRight(), peakY, 1.0f);
+
+        // Peak hold dot
+        g.setColour (Theme::accent);
+        g.fillEllipse ({ inner.getCentreX() - 3.0f, holdY - 3.0f, 6.0f, 6.0f });
+
+        // Reference RMS marker
+        if (referenceActive)
+        {
+            juce::Path marker;
+            marker.addTriangle (inner.getX() - 7.0f, refY - 4.0f, inner.getX() - 7.0f, refY + 4.0f, inner.getX() - 1.0f, refY);
+            g.setColour (Theme::reference);
+            g.fillPath (marker);
+        }
     }
+
+    // Value readout
+    g.setFont (readoutFont);
+    g.setColour (Theme::textSecondary);
+    g.drawText (juce::String (rmsDb, 1) + " dB", meter.readout, juce::Justification::centred);
 }
 
-void NeonScopeAudioProcessorEditor::drawCorrelation (juce::Graphics& g,
-                                                       juce::Rectangle<float> area)
+void NeonScopeAudioProcessorEditor::drawCorrelationChrome (juce::Graphics& g)
 {
-    if (area.isEmpty()) return;
+    const auto& layout = correlationLayout;
+    if (layout.bounds.isEmpty()) return;
 
-    auto labelRow = area.removeFromTop (18.0f);
     g.setColour (Theme::textSecondary);
     g.setFont (juce::Font (Theme::labelSize));
-    g.drawText ("Correlation", labelRow.removeFromLeft (labelRow.getWidth() * 0.6f),
-                juce::Justification::left);
-    g.drawText (juce::String (correlationValue, 2), labelRow, juce::Justification::right);
-
-    area.removeFromTop (4.0f);
+    g.drawText ("Correlation", layout.labelRow.withWidth (layout.labelRow.getWidth() * 0.6f), juce::Justification::left);
+    g.drawText ("Width", layout.widthRow.withWidth (50.0f), juce::Justification::left);
 
     // Track
-    auto track = area.removeFromTop (8.0f);
+    const auto& track = layout.track;
     g.setColour (Theme::knobFace);
     g.fillRoundedRectangle (track, 4.0f);
     g.setColour (Theme::border);
     g.drawRoundedRectangle (track, 4.0f, 0.5f);
 
     // Center line
-    g.setColour (Theme::border);
     g.drawLine (track.getCentreX(), track.getY(), track.getCentreX(), track.getBottom(), 1.0f);
 
+    g.setColour (Theme::knobFace);
+    g.fillRoundedRectangle (layout.widthTrack, 3.0f);
+}
+
+void NeonScopeAudioProcessorEditor::drawCorrelation (juce::Graphics& g)
+{
+    const auto& layout = correlationLayout;
+    if (layout.bounds.isEmpty() || ! g.clipRegionIntersects (layout.bounds.getSmallestIntegerContainer())) return;
+
     // Fill from center
-    const float corrNorm = juce::jlimit (0.0f, 1.0f, (correlationValue + 1.0f) * 0.5f);
-    const float indicatorX = track.getX() + track.getWidth() * corrNorm;
+    const auto& track = layout.track;
+    const float indicatorX = correlationX (track, correlationValue);
 
     juce::Colour corrColour = correlationValue > 0.0f
         ? Theme::accent.withAlpha (0.8f)
         : Theme::danger.withAlpha (0.8f);
 
-    auto fillBar = corrNorm >= 0.5f
+    auto fillBar = indicatorX >= track.getCentreX()
         ? juce::Rectangle<float> (track.getCentreX(), track.getY(),
                                    indicatorX - track.getCentreX(), track.getHeight())
         : juce::Rectangle<float> (indicatorX, track.getY(),
                                    track.getCentreX() - indicatorX, track.getHeight());
-    g.setColour (corrColour);
-    g.fillRect (fillBar);
 
-    g.fillEllipse ({ indicatorX - 5.0f, track.getCentreY() - 5.0f, 10.0f, 10.0f });
+    // Width
+    const auto& widthTrack = layout.widthTrack;
+    auto widthFill = widthTrack.withWidth (widthTrack.getWidth() * juce::jlimit (0.0f, 1.0f, widthValue));
 
-    area.removeFromTop (8.0f);
+    if (correlationLayer.isReady())
+    {
+        correlationLayer.begin();
+        correlationLayer.fillRect (fillBar, corrColour);
+        correlationLayer.fillDisc ({ indicatorX, track.getCentreY() }, 10.0f, corrColour);
+        correlationLayer.fillRoundedRect (widthFill, 3.0f, Theme::accent.withAlpha (0.65f));
+        correlationLayer.blit (g);
+    }
+    else
+    {
+        g.setColour (corrColour);
+        g.fillRect (fillBar);
+        g.fillEllipse ({ indicatorX - 5.0f, track.getCentreY() - 5.0f, 10.0f, 10.0f });
+
+        g.setColour (Theme::accent.withAlpha (0.65f));
+        g.fillRoundedRectangle (widthFill, 3.0f);
+    }
 
-    // Width
-    auto widthLabel = area.removeFromTop (16.0f);
     g.setColour (Theme::textSecondary);
+    g.setFont (labelFont);
+    g.drawText (juce::String (correlationValue, 2), layout.labelRow, juce::Justification::right);
+    g.drawText (juce::String (widthValue, 2), layout.widthRow, juce::Justification::right);
+}
+
+void NeonScopeAudioProcessorEditor::drawLoudnessChrome (juce::Graphics& g)
+{
+    static constexpr const char* names[numLoudnessTiles] { "Momentary", "Short-term", "Integrated", "Range LU", "True peak" };
+
     g.setFont (juce::Font (Theme::labelSize));
-    g.drawText ("Width", widthLabel.removeFromLeft (50.0f), juce::Justification::left);
-    g.drawText (juce::String (widthValue, 2), widthLabel, juce::Justification::right);
 
-    auto widthTrack = area.removeFromTop (6.0f).reduced (0.0f, 1.0f);
-    g.setColour (Theme::knobFace);
-    g.fillRoundedRectangle (widthTrack, 3.0f);
-    auto widthFill = widthTrack.withWidth (widthTrack.getWidth() * juce::jlimit (0.0f, 1.0f, widthValue));
-    g.setColour (Theme::accent.withAlpha (0.65f));
-    g.fillRoundedRectangle (widthFill, 3.0f);
+    for (int i = 0; i < numLoudnessTiles; ++i)
+    {
+        const auto tileArea = loudnessTile (i);
+        g.setColour (Theme::knobFace);
+        g.fillRoundedRectangle (tileArea, 4.0f);
+
+        g.setColour (Theme::textSecondary);
+        g.drawText (names[i], tileArea.reduced (6.0f, 4.0f).removeFromTop (16.0f), juce::Justification::centredLeft);
+    }
 }
 
-void NeonScopeAudioProcessorEditor::drawMeters (juce::Graphics& g,
-                                                  juce::Rectangle<float> area)
+void NeonScopeAudioProcessorEditor::drawLoudness (juce::Graphics& g)
 {
-    if (area.isEmpty()) return;
+    if (loudnessBounds.isEmpty() || ! g.clipRegionIntersects (loudnessBounds.getSmallestIntegerContainer())) return;
 
-    drawPanel (g, area, "Meters");
-    auto content = area.reduced (14.0f).withTrimmedTop (36.0f);
+    const bool truePeakOver = truePeakHoldDb > TruePeakMeter::overThresholdDb;
 
-    auto corrArea = content.removeFromBottom (70.0f);
-    content.removeFromBottom (6.0f);
+    const juce::String values[numLoudnessTiles] {
+        formatLufs (momentaryLufs),
+        formatLufs (shortTermLufs),
+        formatLufs (integratedLufs),
+        juce::String (loudnessRange, 1),
+        truePeakHoldDb <= -99.0f ? juce::String ("--") : juce::String (truePeakHoldDb, 1)
+    };
+
+    g.setFont (tileValueFont);
+
+    for (int i = 0; i < numLoudnessTiles; ++i)
+    {
+        const bool over = i == numLoudnessTiles - 1 && truePeakOver;
+        g.setColour (over ? Theme::danger : Theme::textPrimary);
+        g.drawText (values[i], loudnessTile (i).reduced (6.0f, 4.0f).withTrimmedTop (16.0f), juce::Justification::centredLeft);
+    }
+
+    // Overs, counted per channel each time the -1 dBTP ceiling is crossed,
+    // in the corner of the true-peak tile.
+    if (truePeakOvers > 0)
+    {
+        g.setColour (Theme::danger);
+        g.setFont (labelFont);
+        g.drawText (juce::String (truePeakOvers) + "x", loudnessTile (numLoudnessTiles - 1).reduced (6.0f, 4.0f).withTrimmedTop (16.0f),
+                    juce::Justification::bottomRight);
+    }
+}
 
-    auto leftArea = content.removeFromLeft (content.getWidth() * 0.5f);
-    auto rightArea = content;
+juce::Rectangle<float> NeonScopeAudioProcessorEditor::loudnessTile (int index) const
+{
+    const float tileW = loudnessBounds.getWidth() / (float) numLoudnessTiles;
+    return loudnessBounds.withX (loudnessBounds.getX() + tileW * (float) index).withWidth (tileW).reduced (3.0f, 0.0f);
+}
 
-    drawSingleMeter (g, leftArea, leftRmsDb, leftPeakDb, leftPeakHold, "L");
-    drawSingleMeter (g, rightArea, rightRmsDb, rightPeakDb, rightPeakHold, "R");
-    drawCorrelation (g, corrArea.reduced (6.0f, 0.0f));
+void NeonScopeAudioProcessorEditor::drawMeters (juce::Graphics& g)
+{
+    if (metersBounds.isEmpty()) return;
+
+    drawLoudness (g);
+    drawSingleMeter (g, leftMeter, leftMeterLayer, leftRmsDb, leftPeakDb, leftPeakHold, referenceLeftRmsDb);
+    drawSingleMeter (g, rightMeter, rightMeterLayer, rightRmsDb, rightPeakDb, rightPeakHold, referenceRightRmsDb);
+    drawCorrelation (g);
 
     // Limiter activity indicator
     if (limiterFlash > 0.02f)
     {
-        auto flashBar = area.reduced (14.0f, 0.0f).removeFromTop (2.0f).translated (0.0f, 33.0f);
         g.setColour (Theme::danger.withAlpha (limiterFlash * 0.8f));
-        g.fillRect (flashBar);
+        g.fillRect (limiterFlashBounds);
     }
 }
 
@@ -518,7 +1158,9 @@ void NeonScopeAudioProcessorEditor::drawMeters (juce::Graphics& g,
 //  Editor — Paint
 // ═══════════════════════════════════════════════════════════════════════════════
 
-void NeonScopeAudioProcessorEditor::paint (juce::Graphics& g)
+// Everything that only changes with the editor size: the backdrop, title,
+// panel frames and headers, meter tracks and ticks, and the tile names.
+void NeonScopeAudioProcessorEditor::drawStaticChrome (juce::Graphics& g)
 {
     g.fillAll (Theme::background);
 
@@ -531,10 +1173,88 @@ void NeonScopeAudioProcessorEditor::paint (juce::Graphics& g)
     g.setFont (juce::Font (Theme::labelSize));
     g.drawText ("v2.0", titleBounds.reduced (14.0f, 0.0f), juce::Justification::centredRight);
 
-    drawSpectrum (g);
+    drawPanel (g, spectrumBounds, {});
     drawPanel (g, distortionBounds, "Distortion");
     drawPanel (g, settingsBounds, "Settings");
-    drawMeters (g, metersBounds);
+    drawPanel (g, metersBounds, "Meters");
+
+    drawMeterChrome (g, leftMeter, "L");
+    drawMeterChrome (g, rightMeter, "R");
+    drawCorrelationChrome (g);
+    drawLoudnessChrome (g);
+}
+
+void NeonScopeAudioProcessorEditor::drawBackground (juce::Graphics& g)
+{
+   #if NEONSCOPE_PROFILING
+    if (! backgroundCacheEnabled)
+    {
+        drawStaticChrome (g);
+        prepareRasterLayers();
+        return;
+    }
+   #endif
+
+    // Rendered at the physical pixel scale, so the blit is 1:1 on any display.
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const int width = juce::roundToInt ((float) getWidth() * scale);
+    const int height = juce::roundToInt ((float) getHeight() * scale);
+
+    if (width <= 0 || height <= 0)
+        return;
+
+    if (! backgroundImage.isValid() || backgroundScale != scale
+        || backgroundImage.getWidth() != width || backgroundImage.getHeight() != height)
+    {
+        NEONSCOPE_TRACE_SCOPE ("Editor chrome");
+        backgroundImage = juce::Image (juce::Image::RGB, width, height, false);
+        backgroundScale = scale;
+
+        {
+            juce::Graphics chrome (backgroundImage);
+            chrome.addTransform (juce::AffineTransform::scale (scale));
+            drawStaticChrome (chrome);
+        }
+
+        prepareRasterLayers();
+    }
+
+    g.drawImageTransformed (backgroundImage, juce::AffineTransform::scale (1.0f / backgroundScale));
+}
+
+// Each layer copies the chrome under its shapes, at the same scale, so a
+// frame is one copy, the shapes and one blit.
+void NeonScopeAudioProcessorEditor::prepareRasterLayers()
+{
+    RasterLayer* layers[] { &leftMeterLayer, &rightMeterLayer, &correlationLayer, &bandBarsLayer };
+
+   #if NEONSCOPE_PROFILING
+    if (! backgroundCacheEnabled || ! rasterLayersEnabled)
+    {
+        for (auto* layer : layers)
+            layer->release();
+
+        return;
+    }
+   #endif
+
+    const juce::Rectangle<float> areas[] { leftMeter.shapes, rightMeter.shapes, correlationLayout.shapes, displayBounds };
+
+    for (size_t i = 0; i < std::size (layers); ++i)
+        layers[i]->prepare (backgroundImage, backgroundScale, areas[i]);
+}
+
+void NeonScopeAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    NEONSCOPE_TRACE_SCOPE ("Editor paint");
+    drawBackground (g);
+
+    g.setColour (Theme::reference.withAlpha (0.8f));
+    g.setFont (labelFont);
+    g.drawText (referenceStatus, referenceStatusBounds, juce::Justification::centredLeft, true);
+
+    drawDisplayPanel (g);
+    drawMeters (g);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -545,9 +1265,60 @@ void NeonScopeAudioProcessorEditor::resized()
 {
     const auto M = (int) Theme::margin;
     auto bounds = getLocalBounds().reduced (M);
+    backgroundImage = {};
 
     titleBounds = bounds.removeFromTop (40).toFloat();
-    spectrumBounds = bounds.removeFromTop (100).toFloat();
+    auto referenceRow = bounds.removeFromTop (30).reduced (14, 0);
+    spectrumBounds = bounds.removeFromTop (150).toFloat();
+    displayBounds = spectrumBounds.reduced (12.0f, 8.0f);
+
+    const auto columns = (size_t) juce::jmax (0, (int) displayBounds.getWidth());
+    spectrumCurve.setArea (displayBounds);
+    spectrumCurve.update (spectrumFrame);
+    levelColumns.resize (columns);
+    loudnessColumns.resize (columns);
+
+    // A software image, so columns are written to memory the renderer reads directly.
+    const auto displayArea = displayBounds.toNearestInt();
+
+    if (spectrogramImage.getBounds() != displayArea.withZeroOrigin())
+    {
+        spectrogramImage = displayArea.isEmpty() ? juce::Image()
+                                                 : juce::Image (juce::Image::RGB, displayArea.getWidth(), displayArea.getHeight(),
+                                                                false, juce::SoftwareImageType());
+        spectrogramImage.clear (spectrogramImage.getBounds(), Theme::background);
+        spectrogramWriteX = 0;
+
+        spectrogramRows.resize ((size_t) displayArea.getHeight());
+        for (int y = 0; y < displayArea.getHeight(); ++y)
+            spectrogramRows[(size_t) y] = AnalysisEngine::numSpectrumRows - 1 - y * AnalysisEngine::numSpectrumRows / displayArea.getHeight();
+    }
+
+    goniometer.setSize (juce::roundToInt (displayBounds.getHeight()));
+    oscilloscope.setArea (displayBounds);
+
+    // The view controls share the title row; the reference controls and the
+    // file name have a row of their own, so the name never gets squeezed out.
+    auto titleControls = titleBounds.reduced (14.0f, 0.0f).toNearestInt().withTrimmedRight (44);
+
+   #if NEONSCOPE_PROFILING
+    perfButton.setBounds (titleControls.removeFromRight (64).withSizeKeepingCentre (64, 26));
+   #endif
+    titleControls.removeFromLeft (120);
+    viewBox.setBounds (titleControls.removeFromLeft (104).withSizeKeepingCentre (104, 26));
+    titleControls.removeFromLeft (4);
+    bandAnalysisBox.setBounds (titleControls.removeFromLeft (104).withSizeKeepingCentre (104, 26));
+    scopeTriggerBox.setBounds (bandAnalysisBox.getBounds());
+    titleControls.removeFromLeft (4);
+    smoothingBox.setBounds (titleControls.removeFromLeft (104).withSizeKeepingCentre (104, 26));
+    jassert (titleControls.getWidth() >= 8);
+
+    referenceButton.setBounds (referenceRow.removeFromLeft (86).withSizeKeepingCentre (86, 26));
+    referenceRow.removeFromLeft (4);
+    referenceModeBox.setBounds (referenceRow.removeFromLeft (96).withSizeKeepingCentre (96, 26));
+    referenceRow.removeFromLeft (8);
+    referenceStatusBounds = referenceRow.toFloat();
+    jassert (referenceStatusBounds.getWidth() >= minReferenceStatusWidth);
     bounds.removeFromTop (M);
 
     // Controls row
@@ -560,6 +1331,48 @@ void NeonScopeAudioProcessorEditor::resized()
     bounds.removeFromTop (M);
     metersBounds = bounds.toFloat();
 
+    // ── Meters panel internals ──
+    {
+        auto content = metersBounds.reduced (14.0f).withTrimmedTop (36.0f);
+        limiterFlashBounds = metersBounds.reduced (14.0f, 0.0f).removeFromTop (2.0f).translated (0.0f, 33.0f);
+
+        // Level meters on the left, loudness and correlation beside them.
+        auto meterColumn = content.removeFromLeft (content.getWidth() * 0.4f);
+        content.removeFromLeft (10.0f);
+
+        auto corrArea = content.removeFromBottom (70.0f).reduced (6.0f, 0.0f);
+        content.removeFromBottom (6.0f);
+        loudnessBounds = content;
+
+        auto layoutMeter = [] (juce::Rectangle<float> area)
+        {
+            MeterLayout meter;
+            meter.bounds = area;
+            meter.label = area.removeFromTop (18.0f);
+            meter.readout = area.removeFromBottom (16.0f);
+            const auto meterArea = area.reduced (0.0f, 4.0f);
+            meter.track = meterArea.withSizeKeepingCentre (juce::jmin (14.0f, meterArea.getWidth()), meterArea.getHeight());
+
+            // The hold dot and reference marker overhang the track.
+            meter.shapes = meter.track.withLeft (meter.track.getX() - 8.0f).expanded (0.0f, 4.0f).getIntersection (meter.bounds);
+            return meter;
+        };
+        leftMeter = layoutMeter (meterColumn.removeFromLeft (meterColumn.getWidth() * 0.5f));
+        rightMeter = layoutMeter (meterColumn);
+
+        correlationLayout.bounds = corrArea;
+        correlationLayout.labelRow = corrArea.removeFromTop (18.0f);
+        corrArea.removeFromTop (4.0f);
+        correlationLayout.track = corrArea.removeFromTop (8.0f);
+        corrArea.removeFromTop (8.0f);
+        correlationLayout.widthRow = corrArea.removeFromTop (16.0f);
+        correlationLayout.widthTrack = corrArea.removeFromTop (6.0f).reduced (0.0f, 1.0f);
+
+        // The indicator dot overhangs the track.
+        correlationLayout.shapes = correlationLayout.track.expanded (6.0f).getUnion (correlationLayout.widthTrack);
+        correlationLayout.bounds = correlationLayout.bounds.getUnion (correlationLayout.shapes);
+    }
+
     // ── Distortion panel internals ──
     auto dContent = distortionArea.reduced (12);
     dContent.removeFromTop (36);  // header
@@ -624,84 +1437,330 @@ void NeonScopeAudioProcessorEditor::resized()
     };
     placeFKnob (0, cutoffSlider, cutoffLabel);
     placeFKnob (1, resonanceSlider, resonanceLabel);
+
+   #if NEONSCOPE_PROFILING
+    perfOverlay.setBounds (spectrumBounds.getUnion (distortionBounds).toNearestInt());
+   #endif
 }
 
-// ═══════════════════════════════════════════════════════════════════════════════
-//  Editor — Timer / State
-// ═══════════════════════════════════════════════════════════════════════════════
+void NeonScopeAudioProcessorEditor::mouseDown (const juce::MouseEvent& e)
+{
+    // Clicking the loudness readout starts a new integrated measurement.
+    if (loudnessBounds.contains (e.position))
+        processor.resetLoudness();
+}
 
-void NeonScopeAudioProcessorEditor::timerCallback()
+void NeonScopeAudioProcessorEditor::mouseWheelMove (const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel)
 {
+    if ((view != View::history && view != View::oscilloscope) || ! spectrumBounds.contains (e.position))
+        return;
+
+    // Scroll up to zoom in: from a few seconds out to the full history, or
+    // across the scope's timebase range.
+    const double zoom = std::pow (2.0, -(double) wheel.deltaY * 2.0);
+
+    if (view == View::oscilloscope)
+    {
+        oscilloscope.setTimebase (oscilloscope.getTimebase() * zoom);
+        processor.getValueTreeState().state.setProperty ("scopeTimebase", oscilloscope.getTimebase(), nullptr);
+    }
+    else
+    {
+        historySpanSeconds = juce::jlimit (5.0, LevelHistory::getMaxSpanSeconds(), historySpanSeconds * zoom);
+    }
+
     updateVisualState();
-    refreshKnobLabels();
     repaint();
 }
 
-void NeonScopeAudioProcessorEditor::updateVisualState()
+// ═══════════════════════════════════════════════════════════════════════════════
+//  Editor — Refresh / State
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// May be called on the audio thread during automation. Only sets a bit; the
+// first change since the last batch posts one message for all of them.
+void NeonScopeAudioProcessorEditor::parameterChanged (const juce::String& parameterID, float)
 {
-    bandCache        = processor.getBands();
-    leftLevel        = processor.getLeftLevel();
-    rightLevel       = processor.getRightLevel();
-    leftPeakDb       = processor.getLeftPeakDb();
-    rightPeakDb      = processor.getRightPeakDb();
-    leftRmsDb        = processor.getLeftRmsDb();
-    rightRmsDb       = processor.getRightRmsDb();
-    correlationValue = processor.getCorrelationValue();
-    widthValue       = processor.getWidthValue();
-    autoGainDb       = processor.getAutoGainDb();
-    limiterReduction = processor.getLimiterReductionDb();
-    globalRmsPulse   = processor.getGlobalRmsLevel();
+    for (size_t i = 0; i < std::size (watchedParameterIds); ++i)
+    {
+        if (parameterID == watchedParameterIds[i])
+        {
+            changedParameters.fetch_or (1u << i);
+            triggerAsyncUpdate();
+            return;
+        }
+    }
+}
+
+void NeonScopeAudioProcessorEditor::handleAsyncUpdate()
+{
+    const auto changed = changedParameters.exchange (0);
+    refreshKnobLabels (changed);
+
+    if ((changed & (1u << modeParameter)) != 0)
+        refreshModeState();
+}
+
+// Called on every display refresh while the editor has a window, so an active
+// editor follows the display at 60, 120 or 144 Hz. Once nothing has changed
+// for a while it drops to a few checks a second; a skipped refresh costs one
+// clock read.
+void NeonScopeAudioProcessorEditor::vBlankCallback()
+{
+    if (! isShowing())
+        return;
+
+    const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    const double sinceTick = now - lastTickSeconds;
+
+    if (now - lastChangeSeconds > idleAfterSeconds && sinceTick < idleIntervalSeconds)
+        return;
+
+    lastTickSeconds = now;
+
+    if (tick (juce::jmin (sinceTick, maxTickSeconds)))
+        lastChangeSeconds = now;
+}
+
+// Returns true if anything on screen changed.
+bool NeonScopeAudioProcessorEditor::tick (double elapsedSeconds)
+{
+    NEONSCOPE_TRACE_SCOPE ("Editor tick");
+    updateVisualState (elapsedSeconds);
+    const bool changed = invalidateChangedRegions();
+
+   #if NEONSCOPE_PROFILING
+    // Four refreshes a second is plenty to read and keeps p99 windows meaningful.
+    perfRefreshSeconds -= elapsedSeconds;
+
+    if (perfOverlay.isVisible() && perfRefreshSeconds <= 0.0)
+    {
+        perfOverlay.refresh();
+        perfRefreshSeconds = 0.25;
+    }
+   #endif
+
+    return changed;
+}
+
+void NeonScopeAudioProcessorEditor::updateVisualState (double elapsedSeconds)
+{
+    NEONSCOPE_TRACE_SCOPE ("updateVisualState");
+    // Peaks from every frame since the last tick, so a short transient is not
+    // missed just because a newer frame replaced it.
+    float leftPeakSinceTick = -100.0f, rightPeakSinceTick = -100.0f;
+    processor.getMeterFrames().drainQueue ([&] (const MeterFrame& queued)
+    {
+        leftPeakSinceTick = juce::jmax (leftPeakSinceTick, queued.leftPeakDb);
+        rightPeakSinceTick = juce::jmax (rightPeakSinceTick, queued.rightPeakDb);
+    });
+
+    // Drained whatever the view, so the spectrogram is current when shown.
+    const int newColumns = processor.getSpectrumColumns().drainQueue ([this] (const AnalysisEngine::SpectrumColumn& column)
+    {
+        writeSpectrogramColumn (column);
+    });
+    displayChanged = displayChanged || (view == View::spectrogram && newColumns > 0);
+
+    if (processor.getSpectrumFrames().readLatest (spectrumFrame) && view == View::spectrum)
+        displayChanged = spectrumCurve.update (spectrumFrame) || displayChanged;
+
+    // Drained every tick so the ring never fills, but only plotted while shown.
+    // The scope keeps its history in every view, so it has a trace to show
+    // as soon as it is picked.
+    auto& stereoSamples = processor.getStereoSamples();
+    oscilloscope.setSampleRate (processor.getSampleRate());
+    stereoSamples.read ([this] (juce::uint64 position, const float* left, const float* right, int numSamples)
+    {
+        if (view == View::goniometer)
+            goniometer.addSamples (left, right, numSamples);
+
+        oscilloscope.addSamples (position, left, right, numSamples);
+    });
+
+    if (view == View::goniometer)
+    {
+        goniometer.setSampleRate (processor.getSampleRate());
+        displayChanged = goniometer.update (elapsedSeconds) || displayChanged;
+    }
+
+    if (view == View::history && ! levelColumns.empty())
+    {
+        const auto& history = processor.getLevelHistory();
+        displayChanged = displayChanged || history.getRecordedSeconds() != shownHistorySeconds;
+        shownHistorySeconds = history.getRecordedSeconds();
+        history.summarise (LevelHistory::level, historySpanSeconds, levelColumns.data(), (int) levelColumns.size());
+        history.summarise (LevelHistory::loudness, historySpanSeconds, loudnessColumns.data(), (int) loudnessColumns.size());
+    }
 
-    // Peak hold (~300ms at 60fps)
-    auto updateHold = [] (float db, float& hold, int& timer)
+    MeterFrame frame;
+    if (processor.readMeterFrame (frame))
+    {
+        leftLevel        = frame.leftLevel;
+        rightLevel       = frame.rightLevel;
+        leftPeakDb       = frame.leftPeakDb;
+        rightPeakDb      = frame.rightPeakDb;
+        leftRmsDb        = frame.leftRmsDb;
+        rightRmsDb       = frame.rightRmsDb;
+        correlationValue = frame.correlation;
+        widthValue       = frame.width;
+        autoGainDb       = frame.autoGainDb;
+        limiterReduction = frame.limiterReductionDb;
+        globalRmsPulse   = frame.globalRms;
+        momentaryLufs    = frame.momentaryLufs;
+        shortTermLufs    = frame.shortTermLufs;
+        integratedLufs   = frame.integratedLufs;
+        loudnessRange    = frame.loudnessRange;
+        truePeakHoldDb   = frame.truePeakHoldDb;
+        truePeakOvers    = frame.truePeakOvers;
+
+        oscilloscope.setTransport ({ frame.endSample, frame.ppqAtEnd, frame.bpm, frame.transportPlaying });
+
+        // The curve repaints with its own frames; the filterbank's bars with these.
+        displayChanged = displayChanged || (view == View::spectrum && (bandFilterbank != frame.bandFilterbank
+                                                                       || (frame.bandFilterbank && bandCache != frame.bands)));
+        bandFilterbank = frame.bandFilterbank;
+        bandCache      = frame.bands;
+
+        displayChanged = displayChanged || referenceActive != frame.referenceActive
+                                         || (frame.referenceActive && referenceBandCache != frame.referenceBands);
+
+        referenceActive     = frame.referenceActive;
+        referenceBandCache  = frame.referenceBands;
+        referenceLeftRmsDb  = frame.referenceLeftRmsDb;
+        referenceRightRmsDb = frame.referenceRightRmsDb;
+
+        displayChanged = displayChanged || (view == View::goniometer && bandCorrelations != frame.bandCorrelation);
+        bandCorrelations = frame.bandCorrelation;
+
+        displayChanged = displayChanged || (view == View::spectrum && (sidechainActive != frame.sidechainActive
+                                                                       || sidechainBandCache != frame.sidechainBands
+                                                                       || sidechainMaskingCache != frame.sidechainMasking));
+        sidechainActive       = frame.sidechainActive;
+        sidechainBandCache    = frame.sidechainBands;
+        sidechainMaskingCache = frame.sidechainMasking;
+    }
+
+    // After the frame, so tempo sync uses the newest transport position.
+    if (view == View::oscilloscope)
+        displayChanged = oscilloscope.update() || displayChanged;
+
+    // Rebuilt only when the status or file changes, not every tick.
+    const auto& reference = processor.getReferenceTrack();
+    const auto status = reference.getStatus();
+    const auto file = reference.getFile();
+
+    if (status != referenceStatusSource || file != referenceFileSource)
+    {
+        referenceStatusSource = status;
+        referenceFileSource = file;
+
+        switch (status)
+        {
+            case ReferenceTrack::Status::empty:    referenceStatus = {}; break;
+            case ReferenceTrack::Status::decoding: referenceStatus = "Decoding " + file.getFileName() + "..."; break;
+            case ReferenceTrack::Status::failed:   referenceStatus = "Cannot read " + file.getFileName(); break;
+            case ReferenceTrack::Status::ready:    referenceStatus = file.getFileName(); break;
+        }
+    }
+
+    // Peak hold: held for peakHoldSeconds, then falling for the rest of the tick
+    const auto elapsed = (float) elapsedSeconds;
+    auto updateHold = [elapsed] (float db, float& hold, float& holdSeconds)
     {
         const float incoming = juce::jlimit (0.0f, 1.0f,
             juce::jmap (db, meterDbFloor, peakDbCeiling, 0.0f, 1.0f));
-        if (incoming >= hold) { hold = incoming; timer = 18; return; }
-        if (timer > 0) { --timer; return; }
-        hold = juce::jmax (0.0f, hold - 0.01f);
+        if (incoming >= hold) { hold = incoming; holdSeconds = peakHoldSeconds; return; }
+        holdSeconds -= elapsed;
+        if (holdSeconds >= 0.0f) return;
+        hold = juce::jmax (0.0f, hold + holdSeconds * peakHoldFallPerSecond);
+        holdSeconds = 0.0f;
     };
-    updateHold (leftPeakDb, leftPeakHold, leftPeakHoldTimer);
-    updateHold (rightPeakDb, rightPeakHold, rightPeakHoldTimer);
+    updateHold (juce::jmax (leftPeakDb, leftPeakSinceTick), leftPeakHold, leftPeakHoldSeconds);
+    updateHold (juce::jmax (rightPeakDb, rightPeakSinceTick), rightPeakHold, rightPeakHoldSeconds);
 
     // Limiter flash
     const float flashTarget = limiterReduction < -0.1f
         ? juce::jlimit (0.0f, 1.0f, -limiterReduction / 6.0f) : 0.0f;
-    limiterFlash = limiterFlash * 0.6f + flashTarget * 0.4f;
+    limiterFlash = flashTarget + (limiterFlash - flashTarget) * std::exp (-elapsed / limiterFlashTimeConstant);
 
-    autoGainValueLabel.setText ("AG: " + formatDb (autoGainDb), juce::dontSendNotification);
+    if (const int autoGainSteps = steps (autoGainDb, 10.0f); autoGainSteps != shownAutoGainSteps)
+    {
+        shownAutoGainSteps = autoGainSteps;
+        autoGainValueLabel.setText ("AG: " + formatDb (autoGainDb), juce::dontSendNotification);
+    }
+}
 
-    // Mode-driven enable/disable
-    const auto* modeParam = processor.getValueTreeState().getRawParameterValue ("mode");
-    const int modeVal = modeParam ? juce::roundToInt (modeParam->load()) : 0;
-    const bool processing = modeVal != 0;
-    const bool filterOn   = modeVal == 1 || modeVal == 3;
-    const bool distOn     = modeVal == 2 || modeVal == 3;
+// Compares what each dynamic region would show now with what it showed when
+// last painted, and repaints only those that moved a visible step. The chrome
+// around them comes from the cached background. Returns true if any did.
+bool NeonScopeAudioProcessorEditor::invalidateChangedRegions()
+{
+    NEONSCOPE_TRACE_SCOPE ("invalidateChangedRegions");
+    bool changed = false;
 
-    auto setActive = [] (juce::Component& c, bool on)
+    if (displayChanged)
     {
-        c.setEnabled (on);
-        c.setAlpha (on ? 1.0f : 0.35f);
-    };
-    auto setKnob = [] (juce::Slider& s, juce::Label& l, bool on)
+        displayChanged = false;
+        changed = true;
+        invalidate (displayBounds.expanded (2.0f).getSmallestIntegerContainer());
+    }
+
+    if (referenceStatus != shownReferenceStatus)
     {
-        s.setEnabled (on); l.setEnabled (on);
-        s.setAlpha (on ? 1.0f : 0.3f);
-        l.setAlpha (on ? 1.0f : 0.3f);
+        shownReferenceStatus = referenceStatus;
+        changed = true;
+        invalidate (referenceStatusBounds.getSmallestIntegerContainer());
+    }
+
+    const auto meterValues = [this] (const MeterLayout& meter, float rmsDb, float peakDb, float holdNorm, float referenceDb)
+    {
+        const auto& track = meter.track;
+        return ShownValues { halfPixels (meterLevelY (track, rmsDb, meterDbCeiling)),
+                             halfPixels (meterLevelY (track, peakDb, peakDbCeiling)),
+                             halfPixels (track.getBottom() - track.getHeight() * juce::jlimit (0.0f, 1.0f, holdNorm)),
+                             referenceActive ? halfPixels (meterLevelY (track, referenceDb, meterDbCeiling)) : -1,
+                             steps (rmsDb, 10.0f) };
     };
 
-    setActive (filterTypeBox, filterOn);
-    setKnob (cutoffSlider, cutoffLabel, filterOn);
-    setKnob (resonanceSlider, resonanceLabel, filterOn);
-    setKnob (driveSlider, driveLabel, distOn);
-    setActive (satModeBox, distOn);
-    setActive (oversamplingBox, distOn);
-    setKnob (mixSlider, mixLabel, distOn);
-    setKnob (outputSlider, outputLabel, processing);
-    setKnob (sensitivitySlider, sensitivityLabel, true);
+    changed = invalidateIfChanged (shownLeftMeter, meterValues (leftMeter, leftRmsDb, leftPeakDb, leftPeakHold, referenceLeftRmsDb),
+                                   leftMeter.bounds) || changed;
+    changed = invalidateIfChanged (shownRightMeter, meterValues (rightMeter, rightRmsDb, rightPeakDb, rightPeakHold, referenceRightRmsDb),
+                                   rightMeter.bounds) || changed;
+
+    changed = invalidateIfChanged (shownCorrelation,
+                                   { halfPixels (correlationX (correlationLayout.track, correlationValue)),
+                                     steps (correlationValue, 100.0f),
+                                     correlationValue > 0.0f ? 1 : 0,
+                                     halfPixels (correlationLayout.widthTrack.getWidth() * juce::jlimit (0.0f, 1.0f, widthValue)),
+                                     steps (widthValue, 100.0f) },
+                                   correlationLayout.bounds) || changed;
+
+    changed = invalidateIfChanged (shownLoudness,
+                                   { steps (momentaryLufs, 10.0f), steps (shortTermLufs, 10.0f), steps (integratedLufs, 10.0f),
+                                     steps (loudnessRange, 10.0f), steps (truePeakHoldDb, 10.0f), truePeakOvers },
+                                   loudnessBounds) || changed;
+
+    changed = invalidateIfChanged (shownFlash, { limiterFlash > 0.02f ? steps (limiterFlash * 0.8f, 255.0f) : 0 },
+                                   limiterFlashBounds) || changed;
+    return changed;
+}
 
-    autoGainButton.setAlpha (distOn ? 1.0f : 0.4f);
-    limiterButton.setAlpha (processing ? 1.0f : 0.6f);
-    bandListenButton.setAlpha (filterOn ? 1.0f : 0.35f);
-    autoGainValueLabel.setAlpha (distOn ? 1.0f : 0.4f);
+bool NeonScopeAudioProcessorEditor::invalidateIfChanged (ShownValues& shown, const ShownValues& now, juce::Rectangle<float> area)
+{
+    if (now == shown)
+        return false;
+
+    shown = now;
+    invalidate (area.getSmallestIntegerContainer());
+    return true;
+}
+
+void NeonScopeAudioProcessorEditor::invalidate (juce::Rectangle<int> area)
+{
+    repaint (area);
+
+   #if NEONSCOPE_PROFILING
+    invalidatedArea.add (area);
+   #endif
 }
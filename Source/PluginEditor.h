@@ -1,7 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Goniometer.h"
+#include "Oscilloscope.h"
 #include "PluginProcessor.h"
+#include "RasterLayer.h"
+#include "SpectrumCurve.h"
+#include <limits>
+#include <utility>
 
 // ─── Design Tokens ──────────────────────────────────────────────────────────
 namespace Theme
@@ -16,6 +22,8 @@ namespace Theme
     inline const juce::Colour accent       { 0xff00E0B8 };
     inline const juce::Colour accentDim    { 0xff00A888 };
     inline const juce::Colour danger       { 0xffFF4D4D };
+    inline const juce::Colour reference    { 0xffFFB347 };
+    inline const juce::Colour sidechain    { 0xffB48CFF };
     inline const juce::Colour knobFace     { 0xff1C1F28 };
 
     constexpr float titleSize   = 20.0f;
@@ -48,9 +56,27 @@ public:
                            bool highlighted, bool down) override;
 };
 
+#if NEONSCOPE_PROFILING
+// ─── Performance Overlay ────────────────────────────────────────────────────
+class PerformanceOverlay : public juce::Component
+{
+public:
+    explicit PerformanceOverlay (StageProfiler&);
+
+    void refresh();
+    void paint (juce::Graphics&) override;
+
+private:
+    StageProfiler& profiler;
+    StageProfiler::Snapshot previous;
+    std::array<StageProfiler::StageStats, StageProfiler::numStages> stats {};
+};
+#endif
+
 // ─── Editor ─────────────────────────────────────────────────────────────────
 class NeonScopeAudioProcessorEditor : public juce::AudioProcessorEditor,
-                                      private juce::Timer
+                                      private juce::AudioProcessorValueTreeState::Listener,
+                                      private juce::AsyncUpdater
 {
 public:
     explicit NeonScopeAudioProcessorEditor (NeonScopeAudioProcessor&);
@@ -58,22 +84,105 @@ public:
 
     void paint (juce::Graphics&) override;
     void resized() override;
+    void mouseDown (const juce::MouseEvent&) override;
+    void mouseWheelMove (const juce::MouseEvent&, const juce::MouseWheelDetails&) override;
+
+   #if NEONSCOPE_PROFILING
+    // For the headless paint benchmark: one 60 Hz tick without a display,
+    // the area it invalidated, and the chrome cache and raster layers
+    // switched off to compare.
+    void tickForBenchmark()                         { tick (1.0 / 60.0); }
+    juce::RectangleList<int> takeInvalidatedArea()  { return std::exchange (invalidatedArea, {}); }
+    void setBackgroundCacheEnabled (bool enabled)   { backgroundCacheEnabled = enabled; backgroundImage = {}; }
+    void setRasterLayersEnabled (bool enabled)      { rasterLayersEnabled = enabled; backgroundImage = {}; }
+   #endif
 
 private:
-    // ── Timer / state ───────────────────────────────────────────────────
-    void timerCallback() override;
-    void updateVisualState();
+    // What the display strip at the top shows; ids match viewBox items.
+    enum class View
+    {
+        spectrum = 1,
+        history,
+        spectrogram,
+        goniometer,
+        oscilloscope
+    };
+
+    // Parts of a level meter column: name, track and dB readout. shapes is
+    // where the per-frame fills and marks land, overhang included.
+    struct MeterLayout
+    {
+        juce::Rectangle<float> bounds, label, track, readout, shapes;
+    };
+
+    struct CorrelationLayout
+    {
+        juce::Rectangle<float> bounds, labelRow, track, widthRow, widthTrack, shapes;
+    };
+
+    static constexpr int numLoudnessTiles = 5;
+
+    // The least width the reference file name gets beside its controls.
+    static constexpr float minReferenceStatusWidth = 160.0f;
+
+    // Parameters shown outside their own controls: the knob value labels and
+    // the mode-driven enable states. Ids are in the same order.
+    enum WatchedParameter
+    {
+        cutoffParameter,
+        resonanceParameter,
+        driveParameter,
+        mixParameter,
+        outputParameter,
+        sensitivityParameter,
+        modeParameter,
+        numWatchedParameters
+    };
+
+    static constexpr juce::uint32 allWatchedParameters = (1u << numWatchedParameters) - 1;
+
+    // What a dynamic region last showed, quantised to visible steps; it is
+    // repainted only when that changes.
+    using ShownValues = std::array<int, 8>;
+
+    // ── Refresh / state ─────────────────────────────────────────────────
+    void vBlankCallback();
+    bool tick (double elapsedSeconds);
+    void updateVisualState (double elapsedSeconds = 0.0);
+    bool invalidateChangedRegions();
+    bool invalidateIfChanged (ShownValues& shown, const ShownValues& now, juce::Rectangle<float> area);
+    void invalidate (juce::Rectangle<int> area);
+
+    // ── Parameter listening ─────────────────────────────────────────────
+    void parameterChanged (const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
 
     // ── Helpers ─────────────────────────────────────────────────────────
     void configureKnob (juce::Slider&, juce::Label&, const juce::String& name);
-    void refreshKnobLabels();
+    void refreshKnobLabels (juce::uint32 changedParameters);
+    void refreshModeState();
+    void refreshViewControls();
     void drawPanel (juce::Graphics&, juce::Rectangle<float> area, const juce::String& title);
-    void drawSpectrum (juce::Graphics&);
-    void drawMeters (juce::Graphics&, juce::Rectangle<float> area);
-    void drawSingleMeter (juce::Graphics&, juce::Rectangle<float> area,
-                          float rmsDb, float peakDb, float holdNorm,
-                          const juce::String& label);
-    void drawCorrelation (juce::Graphics&, juce::Rectangle<float> area);
+    void drawStaticChrome (juce::Graphics&);
+    void drawBackground (juce::Graphics&);
+    void prepareRasterLayers();
+    void drawDisplayPanel (juce::Graphics&);
+    void drawSpectrum (juce::Graphics&, juce::Rectangle<float> area);
+    void drawHistory (juce::Graphics&, juce::Rectangle<float> area);
+    void drawSpectrogram (juce::Graphics&, juce::Rectangle<float> area);
+    void drawGoniometer (juce::Graphics&, juce::Rectangle<float> area);
+    void drawOscilloscope (juce::Graphics&, juce::Rectangle<float> area);
+    void writeSpectrogramColumn (const AnalysisEngine::SpectrumColumn&);
+    void drawMeters (juce::Graphics&);
+    void drawMeterChrome (juce::Graphics&, const MeterLayout&, const juce::String& label);
+    void drawSingleMeter (juce::Graphics&, const MeterLayout&, RasterLayer&,
+                          float rmsDb, float peakDb, float holdNorm, float referenceDb);
+    void chooseReferenceFile();
+    void drawCorrelationChrome (juce::Graphics&);
+    void drawCorrelation (juce::Graphics&);
+    void drawLoudnessChrome (juce::Graphics&);
+    void drawLoudness (juce::Graphics&);
+    juce::Rectangle<float> loudnessTile (int index) const;
 
     // ── Core ────────────────────────────────────────────────────────────
     NeonScopeAudioProcessor& processor;
@@ -89,6 +198,16 @@ private:
     juce::Label cutoffLabel, resonanceLabel, driveLabel;
     juce::Label mixLabel, outputLabel, sensitivityLabel;
     juce::Label autoGainValueLabel, monitorModeLabel;
+    juce::TextButton referenceButton { "Reference" };
+    juce::ComboBox referenceModeBox;
+    juce::ComboBox viewBox, bandAnalysisBox, smoothingBox, scopeTriggerBox;
+    std::unique_ptr<juce::FileChooser> referenceChooser;
+
+   #if NEONSCOPE_PROFILING
+    juce::ToggleButton perfButton { "Perf" };
+    PerformanceOverlay perfOverlay;
+    double perfRefreshSeconds = 0.0;
+   #endif
 
     // ── Attachments ─────────────────────────────────────────────────────
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> modeAttachment;
@@ -96,6 +215,8 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> satModeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> monitorModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> referenceModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> bandAnalysisAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> cutoffAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> driveAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> resonanceAttachment;
@@ -106,8 +227,12 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> limiterAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bandListenAttachment;
 
+    // One bit per WatchedParameter, set from whichever thread changed it and
+    // taken as one batch on the message thread.
+    std::array<std::atomic<float>*, numWatchedParameters> watchedValues {};
+    std::atomic<juce::uint32> changedParameters { 0 };
+
     // ── Visual state ────────────────────────────────────────────────────
-    std::array<float, NeonScopeAudioProcessor::numBands> bandCache {};
     float leftLevel = 0.0f, rightLevel = 0.0f;
     float leftPeakDb = -100.0f, rightPeakDb = -100.0f;
     float leftRmsDb = -100.0f, rightRmsDb = -100.0f;
@@ -115,11 +240,74 @@ private:
     float autoGainDb = 0.0f, limiterReduction = 0.0f;
     float globalRmsPulse = 0.0f, limiterFlash = 0.0f;
     float leftPeakHold = 0.0f, rightPeakHold = 0.0f;
-    int leftPeakHoldTimer = 0, rightPeakHoldTimer = 0;
+    float momentaryLufs = LoudnessMeter::silenceLufs, shortTermLufs = LoudnessMeter::silenceLufs;
+    float integratedLufs = LoudnessMeter::silenceLufs, loudnessRange = 0.0f;
+    float truePeakHoldDb = -100.0f;
+    int truePeakOvers = 0;
+    float leftPeakHoldSeconds = 0.0f, rightPeakHoldSeconds = 0.0f;
+    std::array<float, NeonScopeAudioProcessor::numBands> bandCache {}, referenceBandCache {};
+    bool bandFilterbank = false;
+    std::array<float, NeonScopeAudioProcessor::numBands> bandCorrelations {};
+    std::array<float, NeonScopeAudioProcessor::numBands> sidechainBandCache {}, sidechainMaskingCache {};
+    bool sidechainActive = false;
+    float referenceLeftRmsDb = -100.0f, referenceRightRmsDb = -100.0f;
+    bool referenceActive = false;
+    juce::String referenceStatus;
+    ReferenceTrack::Status referenceStatusSource = ReferenceTrack::Status::empty;
+    juce::File referenceFileSource;
+    View view = View::spectrum;
+    AnalysisEngine::Spectrum spectrumFrame;
+    SpectrumCurve spectrumCurve;
+    double historySpanSeconds = 60.0;
+    std::vector<LevelHistory::Column> levelColumns, loudnessColumns;
+
+    // Circular spectrogram: one analysis frame per image column, written in
+    // place at spectrogramWriteX, so the columns right of it are the oldest.
+    juce::Image spectrogramImage;
+    int spectrogramWriteX = 0;
+    std::vector<int> spectrogramRows;   // spectrum row for each image row
+    std::array<juce::PixelRGB, 256> spectrogramColours {};
+
+    Goniometer goniometer;
+    Oscilloscope oscilloscope;
+
+    // Static chrome, rendered once per size and display scale.
+    juce::Image backgroundImage;
+    float backgroundScale = 1.0f;
+
+    // Meter, correlation and filterbank bar shapes, drawn into bitmaps over
+    // copies of that chrome; empty while there is no background image to copy
+    // from.
+    RasterLayer leftMeterLayer, rightMeterLayer, correlationLayer, bandBarsLayer;
+
+    // Fonts for the text drawn every frame, built once.
+    juce::Font labelFont { Theme::labelSize };
+    juce::Font readoutFont { 10.0f };
+    juce::Font tileValueFont { 18.0f, juce::Font::bold };
+
+    ShownValues shownLeftMeter {}, shownRightMeter {}, shownCorrelation {}, shownLoudness {}, shownFlash {};
+    juce::String shownReferenceStatus;
+    int shownAutoGainSteps = std::numeric_limits<int>::min();
+    double shownHistorySeconds = -1.0;
+    bool displayChanged = true;
+
+   #if NEONSCOPE_PROFILING
+    juce::RectangleList<int> invalidatedArea;
+    bool backgroundCacheEnabled = true;
+    bool rasterLayersEnabled = true;
+   #endif
 
     // ── Layout rects ────────────────────────────────────────────────────
-    juce::Rectangle<float> titleBounds, spectrumBounds;
-    juce::Rectangle<float> distortionBounds, settingsBounds, metersBounds;
+    juce::Rectangle<float> titleBounds, spectrumBounds, displayBounds, referenceStatusBounds;
+    juce::Rectangle<float> distortionBounds, settingsBounds, metersBounds, loudnessBounds, limiterFlashBounds;
+    MeterLayout leftMeter, rightMeter;
+    CorrelationLayout correlationLayout;
+
+    // Refresh timing, in Time::getMillisecondCounterHiRes() seconds.
+    double lastTickSeconds = 0.0, lastChangeSeconds = 0.0;
+
+    // Last, so it is detached before anything its callback touches is destroyed.
+    juce::VBlankAttachment vBlankAttachment { this, [this] { vBlankCallback(); } };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NeonScopeAudioProcessorEditor)
 };
@@ -16,6 +16,9 @@ namespace
     constexpr float peakHoldTime = 0.3f;
     constexpr float autoGainSmoothTime = 0.08f;
     constexpr float limiterReleaseTime = 0.05f;
+    constexpr int preparerIdleIntervalMs = 100;
+    constexpr int preparerBusyIntervalMs = 20;
+    constexpr std::array<float, 5> oversamplingFactors { 1.0f, 1.3f, 1.7f, 2.0f, 4.0f };
 
     inline float tanhSat (float sample, float drive)
     {
@@ -88,6 +91,30 @@ namespace
         return static_cast<float> (std::sqrt (sum / static_cast<double> (totalSamples)));
     }
 
+    inline void copyChannels (juce::AudioBuffer<float>& destination, const juce::AudioBuffer<float>& source,
+                              int channels, int numSamples)
+    {
+        for (int ch = 0; ch < channels; ++ch)
+            destination.copyFrom (ch, 0, source, ch, 0, numSamples);
+    }
+
+    // juce::dsp::Oversampling keeps one buffer per stage at that stage's rate;
+    // the filter states on top of that are negligible.
+    inline size_t estimateOversamplerBytes (size_t stages, size_t channels, size_t blockSize)
+    {
+        size_t bytes = sizeof (juce::dsp::Oversampling<float>);
+
+        for (size_t stage = 1; stage <= stages; ++stage)
+            bytes += channels * (blockSize << stage) * sizeof (float);
+
+        return bytes;
+    }
+
+    inline size_t bufferBytes (const juce::AudioBuffer<float>& buffer)
+    {
+        return static_cast<size_t> (buffer.getNumChannels()) * static_cast<size_t> (buffer.getNumSamples()) * sizeof (float);
+    }
+
     inline float normaliseDb (float dbValue, float minDb = meterFloorDb, float maxDb = meterCeilingDb)
     {
         const float clipped = juce::jlimit (minDb, maxDb, dbValue);
@@ -133,6 +160,14 @@ namespace
             return valueAt (originalIndex);
         }
 
+        // The part of this ramp covering [offset, offset + length), as a ramp of its own.
+        BlockRamp slice (int offset, int length) const noexcept
+        {
+            BlockRamp part;
+            part.initialise (valueAt (offset), valueAt (offset + length - 1), length);
+            return part;
+        }
+
         float target = 0.0f;
 
     private:
@@ -149,146 +184,179 @@ namespace
         return current + (target - current) * release;
     }
 
-    inline float roundToDecimals (float value, int decimals)
+    // pow (perSample, n) for every sub-block length, so short blocks skip the pow() call.
+    template <size_t Size>
+    inline void fillBlockCoefficients (std::array<float, Size>& table, double perSample)
     {
-        const float scale = std::pow (10.0f, static_cast<float> (decimals));
-        if (scale <= 0.0f)
-            return value;
-
-        return std::round (value * scale) / scale;
+        for (size_t n = 0; n < Size; ++n)
+            table[n] = static_cast<float> (std::pow (perSample, static_cast<double> (n)));
     }
 
-    inline void pushSamplesIntoFifo (std::vector<float>& fifo, int& index, bool& ready, const float* samples, int numSamples, int fifoSize)
+    template <size_t Size>
+    inline float blockCoefficient (const std::array<float, Size>& table, float perSample, int numSamples)
     {
-        for (int i = 0; i < numSamples; ++i)
-        {
-            fifo[static_cast<size_t> (index)] = samples[i];
-            ++index;
+        if (numSamples >= 0 && numSamples < static_cast<int> (Size))
+            return table[(size_t) numSamples];
 
-            if (index >= fifoSize)
-            {
-                index = 0;
-                ready = true;
-            }
-        }
+        return std::pow (perSample, static_cast<float> (numSamples));
     }
 
-    inline void mapFFTBinsToLogBands (const std::vector<float>& fftData, std::array<std::atomic<float>, 16>& bandLevels,
-                                      int fftSize, double sampleRate, float smoothingFactor)
+    inline float roundToDecimals (float value, int decimals)
     {
-        constexpr float minFreq = 20.0f;
-        constexpr float maxFreq = 20000.0f;
-        constexpr int numBands = 16;
-        constexpr float spectrumFloor = -80.0f;
-        constexpr float spectrumCeiling = -10.0f;
-
-        for (int band = 0; band < numBands; ++band)
-        {
-            const float lowFreq = minFreq * std::pow (maxFreq / minFreq, static_cast<float> (band) / numBands);
-            const float highFreq = minFreq * std::pow (maxFreq / minFreq, static_cast<float> (band + 1) / numBands);
-
-            const int lowBin = juce::jmax (1, static_cast<int> (lowFreq * fftSize / sampleRate));
-            const int highBin = juce::jmin (fftSize / 2, static_cast<int> (highFreq * fftSize / sampleRate));
-
-            float sum = 0.0f;
-            int count = 0;
-
-            for (int bin = lowBin; bin < highBin; ++bin)
-            {
-                const float real = fftData[static_cast<size_t> (bin * 2)];
-                const float imag = fftData[static_cast<size_t> (bin * 2 + 1)];
-                const float magnitude = std::sqrt (real * real + imag * imag);
-                sum += magnitude;
-                ++count;
-            }
+        const float scale = std::pow (10.0f, static_cast<float> (decimals));
+        if (scale <= 0.0f)
+            return value;
 
-            const float avgMagnitude = count > 0 ? sum / count : 0.0f;
-            const float scaledMagnitude = avgMagnitude / static_cast<float> (fftSize);
-            const float dbValue = juce::Decibels::gainToDecibels (scaledMagnitude + epsilon, -120.0f);
-            const float normalised = juce::jlimit (0.0f, 1.0f, juce::jmap (dbValue, spectrumFloor, spectrumCeiling, 0.0f, 1.0f));
-            const float currentValue = bandLevels[band].load();
-            const float smoothed = currentValue * smoothingFactor + normalised * (1.0f - smoothingFactor);
-            bandLevels[band].store (juce::jlimit (0.0f, 1.0f, smoothed));
-        }
+        return std::round (value * scale) / scale;
     }
 }
 
 NeonScopeAudioProcessor::NeonScopeAudioProcessor()
     : juce::AudioProcessor (BusesProperties()
                                 .withInput ("Input", juce::AudioChannelSet::stereo(), true)
-                                .withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
+                                .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                                .withInput ("Sidechain", juce::AudioChannelSet::stereo(), false)),
       parameters (*this, nullptr, "PARAMETERS", createParameterLayout())
 {
-    for (auto& band : bandLevels)
-        band.store (0.0f);
+    parameterHandles.mode = parameters.getRawParameterValue ("mode");
+    parameterHandles.filterType = parameters.getRawParameterValue ("filterType");
+    parameterHandles.cutoff = parameters.getRawParameterValue ("cutoff");
+    parameterHandles.resonance = parameters.getRawParameterValue ("resonance");
+    parameterHandles.drive = parameters.getRawParameterValue ("drive");
+    parameterHandles.satMode = parameters.getRawParameterValue ("satMode");
+    parameterHandles.width = parameters.getRawParameterValue ("width");
+    parameterHandles.mix = parameters.getRawParameterValue ("mix");
+    parameterHandles.outputTrim = parameters.getRawParameterValue ("outputTrim");
+    parameterHandles.oversampling = parameters.getRawParameterValue ("oversampling");
+    parameterHandles.sensitivity = parameters.getRawParameterValue ("sensitivity");
+    parameterHandles.smoothing = parameters.getRawParameterValue ("smoothing");
+    parameterHandles.autoGain = parameters.getRawParameterValue ("AUTO_GAIN");
+    parameterHandles.limiter = parameters.getRawParameterValue ("SAFETY_LIMITER");
+    parameterHandles.bandListen = parameters.getRawParameterValue ("bandListen");
+    parameterHandles.monitorMode = parameters.getRawParameterValue ("monitorMode");
+    parameterHandles.referenceMode = parameters.getRawParameterValue ("referenceMode");
+    parameterHandles.bandAnalysis = parameters.getRawParameterValue ("bandAnalysis");
+
+    referenceBuffer.setSize (2, maxSubBlockSize);
+
+    preparer->thread.addTimeSliceClient (this);
+
+    TraceRecorder::startFromEnvironment();
 }
 
-void NeonScopeAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+NeonScopeAudioProcessor::~NeonScopeAudioProcessor()
 {
-    currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    preparer->thread.removeTimeSliceClient (this);
+}
 
-    const juce::uint32 blockSize = static_cast<juce::uint32> (samplesPerBlock > 0 ? samplesPerBlock : 512);
+void NeonScopeAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    const double newSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    // Host blocks larger than maxSubBlockSize are processed in sub-blocks, so
+    // nothing needs to be sized beyond that. The floor keeps a host that
+    // prepares tiny and then sends large blocks out of 1-sample sub-blocks.
+    const juce::uint32 blockSize = static_cast<juce::uint32> (juce::jlimit (minSubBlockSize, maxSubBlockSize, samplesPerBlock > 0 ? samplesPerBlock : 512));
     const int channelCount = juce::jmax (1, getTotalNumOutputChannels());
-    juce::dsp::ProcessSpec spec { currentSampleRate, blockSize, static_cast<juce::uint32> (channelCount) };
+
+    // Hosts prepare again on transport restarts, sample-rate probes and chain
+    // reorders, usually with nothing changed. Only what depends on a setting
+    // that did change is rebuilt; everything else is reset in place.
+    const bool firstPrepare = preparedChannels == 0;
+    const bool sampleRateChanged = firstPrepare || newSampleRate != currentSampleRate;
+    const bool layoutChanged = firstPrepare || blockSize != preparedBlockSize || channelCount != preparedChannels;
+    currentSampleRate = newSampleRate;
+
+   #if NEONSCOPE_PROFILING
+    profiler.setSampleRate (currentSampleRate);
+   #endif
+
+    if (sampleRateChanged || layoutChanged)
+    {
+        juce::dsp::ProcessSpec spec { currentSampleRate, blockSize, static_cast<juce::uint32> (channelCount) };
+        filterL.prepare (spec);
+        filterR.prepare (spec);
+    }
 
     filterL.reset();
     filterR.reset();
-    filterL.prepare (spec);
-    filterR.prepare (spec);
-
-    oversampler2x = std::make_unique<juce::dsp::Oversampling<float>> (
-        static_cast<size_t> (channelCount),
-        1,
-        juce::dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR);
 
-    oversampler4x = std::make_unique<juce::dsp::Oversampling<float>> (
-        static_cast<size_t> (channelCount),
-        2,
-        juce::dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR);
+    const auto getParamValue = [this] (const juce::String& paramID, float defaultValue)
+    {
+        if (const auto* parameter = parameters.getRawParameterValue (paramID))
+            return parameter->load();
+        return defaultValue;
+    };
 
-    const auto initOversampler = [blockSize] (std::unique_ptr<juce::dsp::Oversampling<float>>& os)
+    // Only what the current settings need is built here; anything selected
+    // later is added by the background preparer.
     {
-        if (os != nullptr)
+        const juce::ScopedLock sl (chainLock);
+        retiredChain.reset();
+
+        const auto wanted = capabilitiesFor (juce::roundToInt (getParamValue ("mode", 0.0f)),
+                                             juce::roundToInt (getParamValue ("oversampling", 0.0f)));
+
+        if (layoutChanged)
         {
-            os->reset();
-            os->initProcessing (static_cast<size_t> (blockSize));
+            activeChain.store (nullptr, std::memory_order_release);
+            ownedChain.reset();
+
+            preparedBlockSize = blockSize;
+            preparedChannels = channelCount;
+            requestedCapabilities.store (wanted, std::memory_order_release);
+
+            if (wanted != 0)
+                publishChain (buildChain (wanted));
         }
-    };
+        else
+        {
+            const auto held = ownedChain != nullptr ? ownedChain->capabilities : 0u;
 
-    initOversampler (oversampler2x);
-    initOversampler (oversampler4x);
-    fractionalUpsamplers.resize (static_cast<size_t> (channelCount));
-    fractionalDownsamplers.resize (static_cast<size_t> (channelCount));
+            if ((wanted & ~held) != 0)
+            {
+                publishChain (buildChain (wanted | held));
+                retiredChain.reset();
+            }
+            else if (ownedChain != nullptr)
+            {
+                ownedChain->reset();
+            }
 
-    for (auto& interp : fractionalUpsamplers)
-        interp.reset();
-    for (auto& interp : fractionalDownsamplers)
-        interp.reset();
+            requestedCapabilities.fetch_or (wanted, std::memory_order_release);
+        }
 
-    const int maxOversampledSamples = static_cast<int> (blockSize * 4u);
-    oversamplingBuffer.setSize (channelCount,
-                                juce::jmax (1, maxOversampledSamples),
-                                false,
-                                false,
-                                true);
-    bandListenBuffer.setSize (channelCount,
-                              static_cast<int> (blockSize),
-                              false,
-                              false,
-                              true);
-
-    fft = std::make_unique<juce::dsp::FFT> (fftOrder);
-    fftData.resize (fftSize * 2, 0.0f);
-    fifoBuffer.resize (fftSize, 0.0f);
-    fifoIndex = 0;
-    nextFFTBlockReady = false;
+        chainSpecReady = true;
+    }
 
-    const auto getParamValue = [this] (const juce::String& paramID, float defaultValue)
+    // Integrated loudness and LRA survive a re-prepare at the same rate; hosts
+    // send those on every transport restart.
+    if (sampleRateChanged)
     {
-        if (const auto* parameter = parameters.getRawParameterValue (paramID))
-            return parameter->load();
-        return defaultValue;
-    };
+        analysis.prepare (currentSampleRate);
+        referenceAnalysis.prepare (currentSampleRate);
+        loudness.prepare (currentSampleRate);
+        levelHistory.prepare (currentSampleRate);
+        bandFilterbank.prepare (currentSampleRate, numBands);
+        truePeak.reset();
+        publishLoudness();
+        publishTruePeak();
+    }
+    else
+    {
+        analysis.reset();
+        referenceAnalysis.reset();
+        bandFilterbank.reset();
+    }
+
+    // Only allocated once a host connects the sidechain; connecting it
+    // prepares again.
+    if (getChannelCountOfBus (true, 1) > 0)
+        sidechainComparison.prepare (currentSampleRate);
+
+    referenceTrack.prepare (currentSampleRate);
+    referenceRmsLeftState = 0.0f;
+    referenceRmsRightState = 0.0f;
+    clearReferenceDisplay();
 
     driveState = getParamValue ("drive", 2.0f);
     mixState = getParamValue ("mix", 1.0f);
@@ -299,30 +367,196 @@ void NeonScopeAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBl
     rmsRightState = 0.0f;
     limiterGain = 1.0f;
 
-    const double sr = juce::jmax (1.0, currentSampleRate);
-    rmsReleasePerSample = std::exp (-1.0 / (juce::jmax (1.0, sr * rmsReleaseTime)));
-    autoGainSmoothingPerSample = std::exp (-1.0 / (juce::jmax (1.0, sr * autoGainSmoothTime)));
-    limiterReleasePerSample = std::exp (-1.0 / (juce::jmax (1.0, sr * limiterReleaseTime)));
+    if (sampleRateChanged)
+    {
+        const double sr = juce::jmax (1.0, currentSampleRate);
+        rmsReleasePerSample = std::exp (-1.0 / (juce::jmax (1.0, sr * rmsReleaseTime)));
+        autoGainSmoothingPerSample = std::exp (-1.0 / (juce::jmax (1.0, sr * autoGainSmoothTime)));
+        limiterReleasePerSample = std::exp (-1.0 / (juce::jmax (1.0, sr * limiterReleaseTime)));
+        fillBlockCoefficients (rmsReleaseBlockCoefficients, rmsReleasePerSample);
+        fillBlockCoefficients (autoGainBlockCoefficients, autoGainSmoothingPerSample);
+    }
 
-    autoGainDisplayDb.store (0.0f);
-    limiterReductionDb.store (0.0f);
-    globalRmsLevel.store (0.0f);
+    meterFrame.sampleRate = currentSampleRate;
+    meterFrame.autoGainDb = 0.0f;
+    meterFrame.limiterReductionDb = 0.0f;
+    meterFrame.globalRms = 0.0f;
+    publishFrame();
 }
 
 void NeonScopeAudioProcessor::releaseResources()
 {
+    // Allocations are kept for the next prepareToPlay, which in most hosts
+    // comes with the same settings; they go away with the processor.
     filterL.reset();
     filterR.reset();
+
+    {
+        const juce::ScopedLock sl (chainLock);
+        retiredChain.reset();
+
+        if (ownedChain != nullptr)
+            ownedChain->reset();
+    }
+
+    autoGainCompensation = 1.0f;
+    limiterGain = 1.0f;
+    analysis.resetMeters();
+}
+
+void NeonScopeAudioProcessor::ProcessingChain::reset()
+{
     if (oversampler2x != nullptr)
         oversampler2x->reset();
     if (oversampler4x != nullptr)
         oversampler4x->reset();
-    fractionalUpsamplers.clear();
-    fractionalDownsamplers.clear();
-    oversamplingBuffer.setSize (0, 0);
-    bandListenBuffer.setSize (0, 0);
-    autoGainCompensation = 1.0f;
-    limiterGain = 1.0f;
+
+    for (auto& interp : fractionalUpsamplers)
+        interp.reset();
+    for (auto& interp : fractionalDownsamplers)
+        interp.reset();
+
+    oversamplingBuffer.clear();
+    bandListenBuffer.clear();
+    dryBuffer.clear();
+}
+
+juce::uint32 NeonScopeAudioProcessor::capabilitiesFor (int mode, int oversamplingChoice)
+{
+    if (mode == 0)
+        return 0;
+
+    juce::uint32 capabilities = ProcessingChain::core;
+
+    if (mode == 2 || mode == 3)
+    {
+        const int index = juce::jlimit (0, static_cast<int> (oversamplingFactors.size() - 1), oversamplingChoice);
+        const float factor = oversamplingFactors[(size_t) index];
+
+        if (factor >= 4.0f)
+            capabilities |= ProcessingChain::oversample4x;
+        else if (factor >= 2.0f)
+            capabilities |= ProcessingChain::oversample2x;
+        else if (factor > 1.0f)
+            capabilities |= ProcessingChain::fractional;
+    }
+
+    return capabilities;
+}
+
+std::unique_ptr<NeonScopeAudioProcessor::ProcessingChain> NeonScopeAudioProcessor::buildChain (juce::uint32 capabilities) const
+{
+    auto chain = std::make_unique<ProcessingChain>();
+    chain->capabilities = capabilities;
+
+    const auto channels = static_cast<size_t> (preparedChannels);
+    const auto blockSize = static_cast<size_t> (preparedBlockSize);
+
+    const auto makeOversampler = [&] (size_t stages)
+    {
+        auto os = std::make_unique<juce::dsp::Oversampling<float>> (
+            channels,
+            stages,
+            juce::dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR);
+
+        os->initProcessing (blockSize);
+        chain->oversamplingBytes += estimateOversamplerBytes (stages, channels, blockSize);
+        return os;
+    };
+
+    if ((capabilities & ProcessingChain::oversample2x) != 0)
+        chain->oversampler2x = makeOversampler (1);
+
+    if ((capabilities & ProcessingChain::oversample4x) != 0)
+        chain->oversampler4x = makeOversampler (2);
+
+    if ((capabilities & ProcessingChain::fractional) != 0)
+    {
+        chain->fractionalUpsamplers.resize (channels);
+        chain->fractionalDownsamplers.resize (channels);
+        chain->interpolationBytes = 2 * channels * sizeof (juce::LagrangeInterpolator);
+
+        // The fractional factors top out at 1.7x, so twice the block is always enough.
+        chain->oversamplingBuffer.setSize (preparedChannels, static_cast<int> (blockSize * 2), false, true, false);
+    }
+
+    if ((capabilities & ProcessingChain::core) != 0)
+    {
+        chain->bandListenBuffer.setSize (preparedChannels, static_cast<int> (blockSize), false, true, false);
+        chain->dryBuffer.setSize (preparedChannels, static_cast<int> (blockSize), false, true, false);
+    }
+
+    chain->bufferBytes = bufferBytes (chain->oversamplingBuffer)
+                       + bufferBytes (chain->bandListenBuffer)
+                       + bufferBytes (chain->dryBuffer);
+
+    return chain;
+}
+
+void NeonScopeAudioProcessor::publishChain (std::unique_ptr<ProcessingChain> chain)
+{
+    jassert (retiredChain == nullptr);
+
+    // Both sides store one of activeChain and completedBlocks and then load the
+    // other, which only seq_cst orders: with acquire/release this load could
+    // see a block that finished after a later block had already read the old
+    // pointer.
+    activeChain.store (chain.get(), std::memory_order_seq_cst);
+    retiredChain = std::move (ownedChain);
+    retiredAtBlock = completedBlocks.load (std::memory_order_seq_cst);
+    ownedChain = std::move (chain);
+}
+
+void NeonScopeAudioProcessor::reclaimRetiredChain()
+{
+    // A block that picked up the old chain before the swap has finished once the
+    // block counter moves on; later blocks can only see the new one.
+    if (retiredChain != nullptr && completedBlocks.load (std::memory_order_seq_cst) != retiredAtBlock)
+        retiredChain.reset();
+}
+
+int NeonScopeAudioProcessor::useTimeSlice()
+{
+    const juce::ScopedLock sl (chainLock);
+    reclaimRetiredChain();
+
+    if (! chainSpecReady || retiredChain != nullptr)
+        return preparerBusyIntervalMs;
+
+    const auto held = ownedChain != nullptr ? ownedChain->capabilities : 0u;
+    const auto wanted = requestedCapabilities.load (std::memory_order_acquire);
+
+    if ((wanted & ~held) == 0)
+        return preparerIdleIntervalMs;
+
+    publishChain (buildChain (wanted | held));
+    return preparerBusyIntervalMs;
+}
+
+NeonScopeAudioProcessor::MemoryFootprint NeonScopeAudioProcessor::getMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+
+    {
+        const juce::ScopedLock sl (chainLock);
+
+        for (const auto* chain : { ownedChain.get(), retiredChain.get() })
+        {
+            if (chain == nullptr)
+                continue;
+
+            footprint.oversampling += chain->oversamplingBytes;
+            footprint.interpolation += chain->interpolationBytes;
+            footprint.processingBuffers += chain->bufferBytes;
+        }
+    }
+
+    footprint.analysis = analysis.getMemoryBytes() + referenceAnalysis.getMemoryBytes() + referenceTrack.getMemoryBytes()
+                        + truePeak.getMemoryBytes() + stereoSamples.getMemoryBytes() + sidechainComparison.getMemoryBytes()
+                        + bandFilterbank.getMemoryBytes();
+    footprint.history = levelHistory.getMemoryBytes();
+
+    return footprint;
 }
 
 bool NeonScopeAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -333,22 +567,74 @@ bool NeonScopeAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
     if (mainInLayout != mainOutLayout)
         return false;
 
-    return mainOutLayout == juce::AudioChannelSet::mono()
-        || mainOutLayout == juce::AudioChannelSet::stereo();
+    if (mainOutLayout != juce::AudioChannelSet::mono() && mainOutLayout != juce::AudioChannelSet::stereo())
+        return false;
+
+    // The sidechain is optional, and mono or stereo when connected.
+    if (layouts.inputBuses.size() < 2)
+        return true;
+
+    const auto sidechainLayout = layouts.getChannelSet (true, 1);
+    return sidechainLayout.isDisabled()
+        || sidechainLayout == juce::AudioChannelSet::mono()
+        || sidechainLayout == juce::AudioChannelSet::stereo();
 }
 
+struct NeonScopeAudioProcessor::BlockSettings
+{
+    int activeChannels = 1;
+    int filterChoice = 0;
+    int satChoice = 0;
+    int monitorModeChoice = 0;
+    float sensitivity = 1.0f;
+    float smoothing = 0.7f;
+    bool autoGainEnabled = true;
+    bool limiterEnabled = true;
+    bool bandListenEnabled = false;
+    bool bandFilterbank = false;
+    bool processingActive = false;
+    bool filterActive = false;
+    bool distortionActive = false;
+    bool widthActive = false;
+    float oversamplingFactor = 1.0f;
+    ProcessingChain* chain = nullptr;
+    juce::dsp::Oversampling<float>* selectedOversampler = nullptr;
+    const float* sidechainLeft = nullptr;    // null while no sidechain is connected
+    const float* sidechainRight = nullptr;   // null for a mono sidechain
+    BlockRamp driveRamp;
+    BlockRamp mixRamp;
+    BlockRamp outputRamp;
+    BlockRamp widthRamp;
+};
+
 void NeonScopeAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
     juce::ignoreUnused (midi);
     juce::ScopedNoDenormals noDenormals;
+    NEONSCOPE_TRACE_SCOPE ("processBlock");
 
-    const int totalNumInputChannels = getTotalNumInputChannels();
-    const int totalNumOutputChannels = getTotalNumOutputChannels();
+   #if NEONSCOPE_PROFILING
+    const auto blockStartTicks = StageProfiler::now();
+    profiler.beginBlock();
+   #endif
+
+    // The sidechain's channels follow the main input's in the buffer, so only
+    // the main bus counts here.
+    const int totalNumInputChannels = getMainBusNumInputChannels();
+    const int totalNumOutputChannels = getMainBusNumOutputChannels();
     const int numSamples = buffer.getNumSamples();
 
     for (int ch = totalNumInputChannels; ch < totalNumOutputChannels; ++ch)
         buffer.clear (ch, 0, numSamples);
 
+    if (loudnessResetRequested.exchange (false))
+    {
+        loudness.reset();
+        truePeak.reset();
+        publishLoudness();
+        publishTruePeak();
+    }
+
     const int activeChannels = juce::jmax (1, juce::jmin (totalNumInputChannels, totalNumOutputChannels));
 
     for (int ch = 0; ch < activeChannels; ++ch)
@@ -360,88 +646,201 @@ void NeonScopeAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
             juce::FloatVectorOperations::copy (destination, source, numSamples);
     }
 
-    const auto getParam = [this] (const juce::String& paramID, float defaultValue) -> float
+    const auto getParam = [] (const std::atomic<float>* parameter, float defaultValue) -> float
     {
-        if (const auto* parameter = parameters.getRawParameterValue (paramID))
-            return parameter->load();
-        return defaultValue;
+        return parameter != nullptr ? parameter->load() : defaultValue;
     };
 
-    const int mode = juce::roundToInt (getParam ("mode", 0.0f));
-    const int filterChoice = juce::roundToInt (getParam ("filterType", 0.0f));
-    const float cutoff = getParam ("cutoff", 8000.0f);
-    const float resonance = getParam ("resonance", 0.7f);
-    const float drive = getParam ("drive", 2.0f);
-    const int satChoice = juce::roundToInt (getParam ("satMode", 0.0f));
-    const float width = getParam ("width", 1.0f);
-    const float mix = getParam ("mix", 1.0f);
-    const float outputTrim = getParam ("outputTrim", 0.0f);
-    const int oversamplingChoice = juce::roundToInt (getParam ("oversampling", 0.0f));
-    const float sensitivity = juce::jlimit (0.1f, 4.0f, getParam ("sensitivity", 1.0f));
-    const float smoothing = juce::jlimit (0.0f, 0.95f, getParam ("smoothing", 0.7f));
-    const bool autoGainEnabled = getParam ("AUTO_GAIN", 1.0f) >= 0.5f;
-    const bool limiterEnabled = getParam ("SAFETY_LIMITER", 1.0f) >= 0.5f;
-    const bool bandListenEnabled = getParam ("bandListen", 0.0f) >= 0.5f;
-    const int monitorModeChoice = juce::jlimit (0, 5, juce::roundToInt (getParam ("monitorMode", 0.0f)));
-
-    const bool processingActive = mode != 0;
-    const bool filterActive = mode == 1 || mode == 3;
-    const bool distortionActive = mode == 2 || mode == 3;
-    const bool widthActive = processingActive && activeChannels == 2;
-
-    static constexpr std::array<float, 5> oversamplingFactors { 1.0f, 1.3f, 1.7f, 2.0f, 4.0f };
-    const int oversamplingIndex = juce::jlimit (0, static_cast<int> (oversamplingFactors.size() - 1), oversamplingChoice);
-    const float oversamplingFactor = oversamplingFactors[oversamplingIndex];
+    const int mode = juce::roundToInt (getParam (parameterHandles.mode, 0.0f));
+    const int oversamplingChoice = juce::roundToInt (getParam (parameterHandles.oversampling, 0.0f));
+
+    BlockSettings settings;
+    settings.activeChannels = activeChannels;
+    settings.filterChoice = juce::roundToInt (getParam (parameterHandles.filterType, 0.0f));
+    settings.satChoice = juce::roundToInt (getParam (parameterHandles.satMode, 0.0f));
+    settings.monitorModeChoice = juce::jlimit (0, 5, juce::roundToInt (getParam (parameterHandles.monitorMode, 0.0f)));
+    settings.sensitivity = juce::jlimit (0.1f, 4.0f, getParam (parameterHandles.sensitivity, 1.0f));
+    settings.smoothing = juce::jlimit (0.0f, 0.95f, getParam (parameterHandles.smoothing, 0.7f));
+    settings.autoGainEnabled = getParam (parameterHandles.autoGain, 1.0f) >= 0.5f;
+    settings.limiterEnabled = getParam (parameterHandles.limiter, 1.0f) >= 0.5f;
+    settings.bandListenEnabled = getParam (parameterHandles.bandListen, 0.0f) >= 0.5f;
+    settings.bandFilterbank = juce::roundToInt (getParam (parameterHandles.bandAnalysis, 0.0f)) == 1;
+
+    // Each mode starts from silence rather than from the other's levels.
+    if (meterFrame.bandFilterbank != settings.bandFilterbank)
+    {
+        meterFrame.bandFilterbank = settings.bandFilterbank;
+        meterFrame.bands.fill (0.0f);
+        bandFilterbank.reset();
+        meterFrameChanged = true;
+    }
 
-    juce::dsp::Oversampling<float>* selectedOversampler = nullptr;
-    if (oversamplingFactor >= 4.0f)
-        selectedOversampler = oversampler4x.get();
-    else if (oversamplingFactor >= 2.0f)
-        selectedOversampler = oversampler2x.get();
+    // Without a sidechain the comparison costs this check and nothing else.
+    const int sidechainChannels = getChannelCountOfBus (true, 1);
 
-    BlockRamp driveRamp;
-    BlockRamp mixRamp;
-    BlockRamp outputRamp;
-    BlockRamp widthRamp;
+    if (sidechainChannels > 0 && sidechainComparison.isPrepared())
+    {
+        const auto sidechain = getBusBuffer (buffer, true, 1);
+        settings.sidechainLeft = sidechain.getReadPointer (0);
+        settings.sidechainRight = sidechainChannels > 1 ? sidechain.getReadPointer (1) : nullptr;
+    }
 
-    const float driveTarget = juce::jlimit (1.0f, 3.0f, drive);
-    const float mixTarget = juce::jlimit (0.0f, 1.0f, mix);
-    const float outputTarget = outputTrim;
-    const float widthTarget = juce::jlimit (0.0f, 2.0f, width);
+    if (meterFrame.sidechainActive != (settings.sidechainLeft != nullptr))
+    {
+        meterFrame.sidechainActive = settings.sidechainLeft != nullptr;
+        meterFrame.sidechainBands.fill (0.0f);
+        meterFrame.sidechainDifferenceDb.fill (0.0f);
+        meterFrame.sidechainMasking.fill (0.0f);
+        sidechainComparison.reset();
+        meterFrameChanged = true;
+    }
 
-    driveRamp.initialise (driveState, driveTarget, numSamples);
-    mixRamp.initialise (mixState, mixTarget, numSamples);
-    outputRamp.initialise (outputTrimState, outputTarget, numSamples);
-    widthRamp.initialise (widthState, widthTarget, numSamples);
+    // Until the preparer has delivered what these settings need, the block runs
+    // with what is already there: dry if the chain itself is missing, 1x if only
+    // the chosen oversampler is.
+    auto* chain = activeChain.load (std::memory_order_seq_cst);
+    const auto requiredCapabilities = capabilitiesFor (mode, oversamplingChoice);
+    const auto availableCapabilities = chain != nullptr ? chain->capabilities : 0u;
+    const bool chainComplete = (requiredCapabilities & ~availableCapabilities) == 0;
 
-    driveState = driveRamp.target;
-    mixState = mixRamp.target;
-    outputTrimState = outputRamp.target;
-    widthState = widthRamp.target;
+    if (! chainComplete)
+        requestedCapabilities.fetch_or (requiredCapabilities, std::memory_order_release);
 
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf (buffer);
+    settings.chain = chain;
+    settings.processingActive = mode != 0 && (availableCapabilities & ProcessingChain::core) != 0;
+    settings.filterActive = settings.processingActive && (mode == 1 || mode == 3);
+    settings.distortionActive = settings.processingActive && (mode == 2 || mode == 3);
+    settings.widthActive = settings.processingActive && activeChannels == 2;
 
-    bool capturedBandBuffer = false;
+    const int oversamplingIndex = juce::jlimit (0, static_cast<int> (oversamplingFactors.size() - 1), oversamplingChoice);
+    settings.oversamplingFactor = settings.distortionActive && chainComplete ? oversamplingFactors[(size_t) oversamplingIndex] : 1.0f;
 
-    if (processingActive)
+    if (settings.oversamplingFactor >= 4.0f)
+        settings.selectedOversampler = chain->oversampler4x.get();
+    else if (settings.oversamplingFactor >= 2.0f)
+        settings.selectedOversampler = chain->oversampler2x.get();
+
+    if (settings.filterActive)
     {
-        if (filterActive)
+        auto type = juce::dsp::StateVariableTPTFilterType::lowpass;
+        if (settings.filterChoice == 1)
+            type = juce::dsp::StateVariableTPTFilterType::highpass;
+        else if (settings.filterChoice == 2)
+            type = juce::dsp::StateVariableTPTFilterType::bandpass;
+
+        filterL.setType (type);
+        filterR.setType (type);
+
+        // Both setters recompute the coefficients, which costs a tan() per call.
+        const float limitedCutoff = juce::jlimit (80.0f, 18000.0f, getParam (parameterHandles.cutoff, 8000.0f));
+        if (limitedCutoff != filterCutoffState)
         {
-            auto type = juce::dsp::StateVariableTPTFilterType::lowpass;
-            if (filterChoice == 1)
-                type = juce::dsp::StateVariableTPTFilterType::highpass;
-            else if (filterChoice == 2)
-                type = juce::dsp::StateVariableTPTFilterType::bandpass;
-
-            filterL.setType (type);
-            filterR.setType (type);
-            const float limitedCutoff = juce::jlimit (80.0f, 18000.0f, cutoff);
             filterL.setCutoffFrequency (limitedCutoff);
             filterR.setCutoffFrequency (limitedCutoff);
-            const float limitedResonance = juce::jlimit (0.2f, 1.5f, resonance);
+            filterCutoffState = limitedCutoff;
+        }
+
+        const float limitedResonance = juce::jlimit (0.2f, 1.5f, getParam (parameterHandles.resonance, 0.7f));
+        if (limitedResonance != filterResonanceState)
+        {
             filterL.setResonance (limitedResonance);
             filterR.setResonance (limitedResonance);
+            filterResonanceState = limitedResonance;
+        }
+    }
+
+    const float driveTarget = juce::jlimit (1.0f, 3.0f, getParam (parameterHandles.drive, 2.0f));
+    const float mixTarget = juce::jlimit (0.0f, 1.0f, getParam (parameterHandles.mix, 1.0f));
+    const float outputTarget = getParam (parameterHandles.outputTrim, 0.0f);
+    const float widthTarget = juce::jlimit (0.0f, 2.0f, getParam (parameterHandles.width, 1.0f));
+
+    settings.driveRamp.initialise (driveState, driveTarget, numSamples);
+    settings.mixRamp.initialise (mixState, mixTarget, numSamples);
+    settings.outputRamp.initialise (outputTrimState, outputTarget, numSamples);
+    settings.widthRamp.initialise (widthState, widthTarget, numSamples);
+
+    driveState = settings.driveRamp.target;
+    mixState = settings.mixRamp.target;
+    outputTrimState = settings.outputRamp.target;
+    widthState = settings.widthRamp.target;
+
+    // The chain is sized for preparedBlockSize, so larger host blocks are cut
+    // into sub-blocks instead of growing any buffer here.
+    const int subBlockSize = static_cast<int> (juce::jmax ((juce::uint32) minSubBlockSize, preparedBlockSize));
+    float minLimiterGain = 1.0f;
+
+    for (int startSample = 0; startSample < numSamples; startSample += subBlockSize)
+    {
+        const int subBlockSamples = juce::jmin (subBlockSize, numSamples - startSample);
+        juce::AudioBuffer<float> subBlock (buffer.getArrayOfWritePointers(), activeChannels, startSample, subBlockSamples);
+        minLimiterGain = juce::jmin (minLimiterGain, processSubBlock (subBlock, settings, startSample));
+    }
+
+    meterFrame.limiterReductionDb = settings.limiterEnabled ? juce::Decibels::gainToDecibels (minLimiterGain, -120.0f) : 0.0f;
+    meterFrame.autoGainDb = juce::Decibels::gainToDecibels (autoGainCompensation, -120.0f);
+    meterFrame.endSample += (juce::uint64) numSamples;
+
+    // One playhead query per block, shared by the reference track and the
+    // transport published for tempo-synced displays.
+    juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+
+    if (auto* playHead = getPlayHead())
+        position = playHead->getPosition();
+
+    const auto ppq = position.hasValue() ? position->getPpqPosition() : juce::Optional<double>();
+    const auto bpm = position.hasValue() ? position->getBpm() : juce::Optional<double>();
+    meterFrame.transportPlaying = position.hasValue() && position->getIsPlaying() && ppq.hasValue() && bpm.hasValue() && *bpm > 0.0;
+    meterFrame.bpm = meterFrame.transportPlaying ? *bpm : 0.0;
+    meterFrame.ppqAtEnd = meterFrame.transportPlaying ? *ppq + numSamples * *bpm / (60.0 * currentSampleRate) : 0.0;
+
+    processReference (buffer, position, juce::roundToInt (getParam (parameterHandles.referenceMode, 0.0f)),
+                      settings.sensitivity, settings.smoothing);
+
+    // Tiny host blocks only accumulate; the dB conversions, ballistics and
+    // stores run once enough samples have been seen.
+    if (analysis.getMeters().samples >= meterPublishSamples)
+    {
+        NEONSCOPE_PROFILE_STAGE (profiler, metering);
+        NEONSCOPE_TRACE_SCOPE ("Metering");
+        publishMeters (settings.sensitivity, settings.smoothing);
+    }
+
+    if (meterFrameChanged)
+        publishFrame();
+
+   #if NEONSCOPE_PROFILING
+    profiler.endBlock (numSamples, StageProfiler::now() - blockStartTicks);
+   #endif
+
+    // seq_cst, paired with publishChain.
+    completedBlocks.fetch_add (1, std::memory_order_seq_cst);
+}
+
+float NeonScopeAudioProcessor::processSubBlock (juce::AudioBuffer<float>& buffer, const BlockSettings& settings, int startSample)
+{
+    const int numSamples = buffer.getNumSamples();
+    const int activeChannels = settings.activeChannels;
+    auto* chain = settings.chain;
+
+    const auto driveRamp = settings.driveRamp.slice (startSample, numSamples);
+    const auto mixRamp = settings.mixRamp.slice (startSample, numSamples);
+    const auto outputRamp = settings.outputRamp.slice (startSample, numSamples);
+    const auto widthRamp = settings.widthRamp.slice (startSample, numSamples);
+
+    const bool processingActive = settings.processingActive;
+    const bool distortionActive = settings.distortionActive;
+    const float oversamplingFactor = settings.oversamplingFactor;
+    bool capturedBandBuffer = false;
+
+    if (processingActive)
+    {
+        jassert (chain->dryBuffer.getNumChannels() >= activeChannels && chain->dryBuffer.getNumSamples() >= numSamples);
+        copyChannels (chain->dryBuffer, buffer, activeChannels, numSamples);
+
+        if (settings.filterActive)
+        {
+            NEONSCOPE_PROFILE_STAGE (profiler, filter);
+            NEONSCOPE_TRACE_SCOPE ("Filter");
 
             for (int channel = 0; channel < activeChannels; ++channel)
             {
@@ -452,32 +851,16 @@ void NeonScopeAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                     data[i] = filter.processSample (0, data[i]);
             }
 
-            if (bandListenEnabled)
+            if (settings.bandListenEnabled)
             {
-                if (bandListenBuffer.getNumChannels() != activeChannels
-                    || bandListenBuffer.getNumSamples() != numSamples)
-                {
-                    bandListenBuffer.setSize (activeChannels,
-                                              numSamples,
-                                              false,
-                                              false,
-                                              true);
-                }
-
-                for (int channel = 0; channel < activeChannels; ++channel)
-                    bandListenBuffer.copyFrom (channel, 0, buffer, channel, 0, numSamples);
-
+                copyChannels (chain->bandListenBuffer, buffer, activeChannels, numSamples);
                 capturedBandBuffer = true;
             }
         }
-        else
-        {
-            capturedBandBuffer = false;
-        }
 
         if (distortionActive)
         {
-            const auto saturate = [satChoice] (float sample, float driveValue)
+            const auto saturate = [satChoice = settings.satChoice] (float sample, float driveValue)
             {
                 switch (satChoice)
                 {
@@ -505,53 +888,67 @@ void NeonScopeAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                 }
             };
 
-            if (oversamplingFactor > 1.0f && selectedOversampler != nullptr)
+            if (oversamplingFactor > 1.0f && settings.selectedOversampler != nullptr)
             {
-                selectedOversampler->initProcessing (static_cast<size_t> (numSamples));
                 juce::dsp::AudioBlock<float> block (buffer);
-                auto oversampledBlock = selectedOversampler->processSamplesUp (block);
-                processNonLinear (oversampledBlock, oversamplingFactor);
-                selectedOversampler->processSamplesDown (block);
+                juce::dsp::AudioBlock<float> oversampledBlock;
+
+                {
+                    NEONSCOPE_PROFILE_STAGE (profiler, oversampling);
+                    NEONSCOPE_TRACE_SCOPE ("Oversampling");
+                    oversampledBlock = settings.selectedOversampler->processSamplesUp (block);
+                }
+
+                {
+                    NEONSCOPE_PROFILE_STAGE (profiler, saturation);
+                    NEONSCOPE_TRACE_SCOPE ("Saturation");
+                    processNonLinear (oversampledBlock, oversamplingFactor);
+                }
+
+                NEONSCOPE_PROFILE_STAGE (profiler, oversampling);
+                NEONSCOPE_TRACE_SCOPE ("Oversampling");
+                settings.selectedOversampler->processSamplesDown (block);
             }
             else if (oversamplingFactor > 1.0f)
             {
+                auto& fractionalUpsamplers = chain->fractionalUpsamplers;
+                auto& fractionalDownsamplers = chain->fractionalDownsamplers;
+                jassert (static_cast<int> (fractionalUpsamplers.size()) >= activeChannels);
+
                 const int oversampledSamples = juce::jmax (1, static_cast<int> (std::ceil (numSamples * oversamplingFactor)));
-                if (oversamplingBuffer.getNumChannels() != activeChannels
-                    || oversamplingBuffer.getNumSamples() != oversampledSamples)
-                {
-                    oversamplingBuffer.setSize (activeChannels,
-                                                oversampledSamples,
-                                                false,
-                                                false,
-                                                true);
-                }
+                jassert (chain->oversamplingBuffer.getNumSamples() >= oversampledSamples);
+
+                juce::dsp::AudioBlock<float> oversampledBlock (chain->oversamplingBuffer.getArrayOfWritePointers(),
+                                                               static_cast<size_t> (activeChannels),
+                                                               static_cast<size_t> (oversampledSamples));
 
-                if (static_cast<int> (fractionalUpsamplers.size()) < activeChannels)
                 {
-                    fractionalUpsamplers.resize (static_cast<size_t> (activeChannels));
-                    fractionalDownsamplers.resize (static_cast<size_t> (activeChannels));
-                    for (auto& interp : fractionalUpsamplers)
-                        interp.reset();
-                    for (auto& interp : fractionalDownsamplers)
-                        interp.reset();
+                    NEONSCOPE_PROFILE_STAGE (profiler, oversampling);
+                    NEONSCOPE_TRACE_SCOPE ("Oversampling");
+
+                    for (int channel = 0; channel < activeChannels; ++channel)
+                    {
+                        const auto* src = buffer.getReadPointer (channel);
+                        auto* dest = oversampledBlock.getChannelPointer (static_cast<size_t> (channel));
+                        fractionalUpsamplers[(size_t) channel].process (1.0 / oversamplingFactor,
+                                                                        src,
+                                                                        dest,
+                                                                        oversampledSamples);
+                    }
                 }
 
-                for (int channel = 0; channel < activeChannels; ++channel)
                 {
-                    const auto* src = buffer.getReadPointer (channel);
-                    auto* dest = oversamplingBuffer.getWritePointer (channel);
-                    fractionalUpsamplers[(size_t) channel].process (1.0 / oversamplingFactor,
-                                                                    src,
-                                                                    dest,
-                                                                    oversampledSamples);
+                    NEONSCOPE_PROFILE_STAGE (profiler, saturation);
+                    NEONSCOPE_TRACE_SCOPE ("Saturation");
+                    processNonLinear (oversampledBlock, oversamplingFactor);
                 }
 
-                juce::dsp::AudioBlock<float> oversampledBlock (oversamplingBuffer);
-                processNonLinear (oversampledBlock, oversamplingFactor);
+                NEONSCOPE_PROFILE_STAGE (profiler, oversampling);
+                NEONSCOPE_TRACE_SCOPE ("Oversampling");
 
                 for (int channel = 0; channel < activeChannels; ++channel)
                 {
-                    const auto* src = oversamplingBuffer.getReadPointer (channel);
+                    const auto* src = oversampledBlock.getChannelPointer (static_cast<size_t> (channel));
                     auto* dest = buffer.getWritePointer (channel);
                     fractionalDownsamplers[(size_t) channel].process (oversamplingFactor,
                                                                       src,
@@ -561,13 +958,18 @@ void NeonScopeAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
             }
             else
             {
+                NEONSCOPE_PROFILE_STAGE (profiler, saturation);
+                NEONSCOPE_TRACE_SCOPE ("Saturation");
                 juce::dsp::AudioBlock<float> block (buffer);
                 processNonLinear (block, 1.0f);
             }
         }
 
-        if (widthActive)
+        if (settings.widthActive)
         {
+            NEONSCOPE_PROFILE_STAGE (profiler, width);
+            NEONSCOPE_TRACE_SCOPE ("Width");
+
             auto* left = buffer.getWritePointer (0);
             auto* right = buffer.getWritePointer (1);
 
@@ -585,226 +987,296 @@ void NeonScopeAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         }
     }
 
-    const bool shouldBlendDistortion = processingActive && distortionActive;
-    const float wetMixTarget = shouldBlendDistortion ? mixRamp.target : 0.0f;
-    const bool wetBlendActive = shouldBlendDistortion && wetMixTarget > 0.0f;
-
-    const float autoGainCoeffBlock = std::pow (autoGainSmoothingPerSample, numSamples);
-
-    if (autoGainEnabled && distortionActive && wetMixTarget > 0.0f)
     {
-        const float dryRms = computeBufferRms (dryBuffer, activeChannels, numSamples);
-        const float wetRms = computeBufferRms (buffer, activeChannels, numSamples);
-        float targetGain = 1.0f;
+        NEONSCOPE_PROFILE_STAGE (profiler, gain);
+        NEONSCOPE_TRACE_SCOPE ("Gain & mix");
 
-        if (dryRms > epsilon && wetRms > epsilon)
-            targetGain = juce::jlimit (0.125f, 8.0f, dryRms / juce::jmax (wetRms, epsilon));
+        const bool shouldBlendDistortion = processingActive && distortionActive;
+        const float wetMixTarget = shouldBlendDistortion ? mixRamp.target : 0.0f;
 
-        autoGainCompensation = autoGainCompensation * autoGainCoeffBlock + targetGain * (1.0f - autoGainCoeffBlock);
-        buffer.applyGain (autoGainCompensation);
-    }
-    else
-    {
-        autoGainCompensation = autoGainCompensation * autoGainCoeffBlock + 1.0f * (1.0f - autoGainCoeffBlock);
-    }
+        const float autoGainCoeffBlock = blockCoefficient (autoGainBlockCoefficients, autoGainSmoothingPerSample, numSamples);
 
-    bool replacedWithDry = false;
+        if (settings.autoGainEnabled && distortionActive && wetMixTarget > 0.0f)
+        {
+            const float dryRms = computeBufferRms (chain->dryBuffer, activeChannels, numSamples);
+            const float wetRms = computeBufferRms (buffer, activeChannels, numSamples);
+            float targetGain = 1.0f;
 
-    if (shouldBlendDistortion)
-    {
-        if (wetMixTarget <= 0.0f)
+            if (dryRms > epsilon && wetRms > epsilon)
+                targetGain = juce::jlimit (0.125f, 8.0f, dryRms / juce::jmax (wetRms, epsilon));
+
+            autoGainCompensation = autoGainCompensation * autoGainCoeffBlock + targetGain * (1.0f - autoGainCoeffBlock);
+            buffer.applyGain (autoGainCompensation);
+        }
+        else
         {
-            buffer.makeCopyOf (dryBuffer);
-            replacedWithDry = true;
+            autoGainCompensation = autoGainCompensation * autoGainCoeffBlock + 1.0f * (1.0f - autoGainCoeffBlock);
         }
-        else if (wetMixTarget < 1.0f)
+
+        bool replacedWithDry = false;
+
+        if (shouldBlendDistortion)
         {
-            for (int channel = 0; channel < activeChannels; ++channel)
+            if (wetMixTarget <= 0.0f)
             {
-                const auto* dryData = dryBuffer.getReadPointer (channel);
-                auto* wetData = buffer.getWritePointer (channel);
-
-                for (int sample = 0; sample < numSamples; ++sample)
+                copyChannels (buffer, chain->dryBuffer, activeChannels, numSamples);
+                replacedWithDry = true;
+            }
+            else if (wetMixTarget < 1.0f)
+            {
+                for (int channel = 0; channel < activeChannels; ++channel)
                 {
-                    const float wetAmount = mixRamp.valueAt (sample);
-                    const float dryAmount = 1.0f - wetAmount;
-                    wetData[sample] = dryAmount * dryData[sample] + wetAmount * wetData[sample];
+                    const auto* dryData = chain->dryBuffer.getReadPointer (channel);
+                    auto* wetData = buffer.getWritePointer (channel);
+
+                    for (int sample = 0; sample < numSamples; ++sample)
+                    {
+                        const float wetAmount = mixRamp.valueAt (sample);
+                        const float dryAmount = 1.0f - wetAmount;
+                        wetData[sample] = dryAmount * dryData[sample] + wetAmount * wetData[sample];
+                    }
                 }
             }
         }
-    }
 
-    const bool applyOutputGain = processingActive && (! shouldBlendDistortion || wetMixTarget > 0.0f);
-    if (applyOutputGain)
-    {
-        for (int channel = 0; channel < activeChannels; ++channel)
+        const bool applyOutputGain = processingActive && (! shouldBlendDistortion || wetMixTarget > 0.0f);
+        if (applyOutputGain)
         {
-            auto* data = buffer.getWritePointer (channel);
-            for (int sample = 0; sample < numSamples; ++sample)
+            for (int channel = 0; channel < activeChannels; ++channel)
             {
-                const float gain = juce::Decibels::decibelsToGain (outputRamp.valueAt (sample));
-                data[sample] *= gain;
+                auto* data = buffer.getWritePointer (channel);
+                for (int sample = 0; sample < numSamples; ++sample)
+                {
+                    const float gain = juce::Decibels::decibelsToGain (outputRamp.valueAt (sample));
+                    data[sample] *= gain;
+                }
             }
         }
-    }
-    else if (! replacedWithDry)
-    {
-        buffer.makeCopyOf (dryBuffer);
-    }
+        else if (processingActive && ! replacedWithDry)
+        {
+            copyChannels (buffer, chain->dryBuffer, activeChannels, numSamples);
+        }
 
-    if (bandListenEnabled && capturedBandBuffer)
-    {
-        for (int channel = 0; channel < activeChannels; ++channel)
-            buffer.copyFrom (channel, 0, bandListenBuffer, channel, 0, numSamples);
-    }
+        if (settings.bandListenEnabled && capturedBandBuffer)
+            copyChannels (buffer, chain->bandListenBuffer, activeChannels, numSamples);
 
-    auto applyMonitorMode = [&] (int selection)
-    {
-        if (selection == 0 || activeChannels == 0)
-            return;
+        auto applyMonitorMode = [&] (int selection)
+        {
+            if (selection == 0 || activeChannels == 0)
+                return;
 
-        auto* left = buffer.getWritePointer (0);
-        auto* right = activeChannels > 1 ? buffer.getWritePointer (1) : nullptr;
+            auto* left = buffer.getWritePointer (0);
+            auto* right = activeChannels > 1 ? buffer.getWritePointer (1) : nullptr;
 
-        switch (selection)
-        {
-            case 1: // Mono
-                for (int i = 0; i < numSamples; ++i)
-                {
-                    const float R = right != nullptr ? right[i] : left[i];
-                    const float mono = 0.5f * (left[i] + R);
-                    left[i] = mono;
-                    if (right != nullptr)
-                        right[i] = mono;
-                }
-                break;
-            case 2: // Left
-                if (right != nullptr)
-                    juce::FloatVectorOperations::copy (right, left, numSamples);
-                break;
-            case 3: // Right
-                if (right != nullptr)
-                {
+            switch (selection)
+            {
+                case 1: // Mono
                     for (int i = 0; i < numSamples; ++i)
                     {
-                        const float val = right[i];
-                        left[i] = val;
-                        right[i] = val;
+                        const float R = right != nullptr ? right[i] : left[i];
+                        const float mono = 0.5f * (left[i] + R);
+                        left[i] = mono;
+                        if (right != nullptr)
+                            right[i] = mono;
                     }
-                }
-                break;
-            case 4: // Mid
-                if (right != nullptr)
-                {
-                    for (int i = 0; i < numSamples; ++i)
+                    break;
+                case 2: // Left
+                    if (right != nullptr)
+                        juce::FloatVectorOperations::copy (right, left, numSamples);
+                    break;
+                case 3: // Right
+                    if (right != nullptr)
                     {
-                        const float mid = 0.5f * (left[i] + right[i]);
-                        left[i] = mid;
-                        right[i] = mid;
+                        for (int i = 0; i < numSamples; ++i)
+                        {
+                            const float val = right[i];
+                            left[i] = val;
+                            right[i] = val;
+                        }
                     }
-                }
-                break;
-            case 5: // Side
-                if (right != nullptr)
-                {
-                    for (int i = 0; i < numSamples; ++i)
+                    break;
+                case 4: // Mid
+                    if (right != nullptr)
                     {
-                        const float side = 0.5f * (left[i] - right[i]);
-                        left[i] = side;
-                        right[i] = -side;
+                        for (int i = 0; i < numSamples; ++i)
+                        {
+                            const float mid = 0.5f * (left[i] + right[i]);
+                            left[i] = mid;
+                            right[i] = mid;
+                        }
                     }
-                }
-                break;
-            default:
-                break;
-        }
-    };
-
-    applyMonitorMode (monitorModeChoice);
+                    break;
+                case 5: // Side
+                    if (right != nullptr)
+                    {
+                        for (int i = 0; i < numSamples; ++i)
+                        {
+                            const float side = 0.5f * (left[i] - right[i]);
+                            left[i] = side;
+                            right[i] = -side;
+                        }
+                    }
+                    break;
+                default:
+                    break;
+            }
+        };
 
-    for (int channel = 0; channel < activeChannels; ++channel)
-    {
-        auto* data = buffer.getWritePointer (channel);
-        for (int sample = 0; sample < numSamples; ++sample)
-            data[sample] = juce::jlimit (-1.0f, 1.0f, data[sample]);
+        applyMonitorMode (settings.monitorModeChoice);
     }
 
-    const float threshold = juce::Decibels::decibelsToGain (-0.3f);
     float minLimiterGain = 1.0f;
 
-    if (limiterEnabled)
     {
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            float framePeak = 0.0f;
-            for (int channel = 0; channel < activeChannels; ++channel)
-                framePeak = juce::jmax (framePeak, std::abs (buffer.getSample (channel, sample)));
+        NEONSCOPE_PROFILE_STAGE (profiler, limiter);
+        NEONSCOPE_TRACE_SCOPE ("Limiter");
 
-            const float target = framePeak > threshold ? threshold / (framePeak + epsilon) : 1.0f;
+        for (int channel = 0; channel < activeChannels; ++channel)
+        {
+            auto* data = buffer.getWritePointer (channel);
+            for (int sample = 0; sample < numSamples; ++sample)
+                data[sample] = juce::jlimit (-1.0f, 1.0f, data[sample]);
+        }
 
-            if (target < limiterGain)
-                limiterGain = target;
-            else
-                limiterGain = limiterGain + (1.0f - limiterGain) * (1.0f - limiterReleasePerSample);
+        const float threshold = juce::Decibels::decibelsToGain (-0.3f);
 
-            for (int channel = 0; channel < activeChannels; ++channel)
+        if (settings.limiterEnabled)
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
             {
-                float sampleValue = buffer.getSample (channel, sample) * limiterGain;
-                buffer.setSample (channel, sample, sampleValue);
-            }
+                float framePeak = 0.0f;
+                for (int channel = 0; channel < activeChannels; ++channel)
+                    framePeak = juce::jmax (framePeak, std::abs (buffer.getSample (channel, sample)));
 
-            minLimiterGain = juce::jmin (minLimiterGain, limiterGain);
-        }
+                const float target = framePeak > threshold ? threshold / (framePeak + epsilon) : 1.0f;
+
+                if (target < limiterGain)
+                    limiterGain = target;
+                else
+                    limiterGain = limiterGain + (1.0f - limiterGain) * (1.0f - limiterReleasePerSample);
+
+                for (int channel = 0; channel < activeChannels; ++channel)
+                {
+                    float sampleValue = buffer.getSample (channel, sample) * limiterGain;
+                    buffer.setSample (channel, sample, sampleValue);
+                }
 
-        limiterReductionDb.store (juce::Decibels::gainToDecibels (minLimiterGain, -120.0f));
+                minLimiterGain = juce::jmin (minLimiterGain, limiterGain);
+            }
+        }
+        else
+        {
+            limiterGain = 1.0f;
+        }
     }
-    else
+
+    // Metering
+    const float* leftData = buffer.getReadPointer (0);
+    const float* rightData = activeChannels > 1 ? buffer.getReadPointer (1) : nullptr;
+
     {
-        limiterGain = 1.0f;
-        limiterReductionDb.store (0.0f);
+        NEONSCOPE_PROFILE_STAGE (profiler, metering);
+        NEONSCOPE_TRACE_SCOPE ("Metering");
+        analysis.accumulateMeters (leftData, rightData, numSamples);
+        stereoSamples.push (leftData, rightData, numSamples);
     }
 
-    autoGainDisplayDb.store (juce::Decibels::gainToDecibels (autoGainCompensation, -120.0f));
+    {
+        NEONSCOPE_PROFILE_STAGE (profiler, loudness);
+        NEONSCOPE_TRACE_SCOPE ("Loudness");
 
-    // Metering
-    const float sensitivityDbOffset = juce::Decibels::gainToDecibels (sensitivity, -120.0f);
-    const float meterAttack = juce::jmap (smoothing, 0.0f, 0.95f, 0.45f, 0.2f);
-    const float meterRelease = juce::jmap (smoothing, 0.0f, 0.95f, 0.08f, 0.03f);
-    const float bandAttack = juce::jmap (smoothing, 0.0f, 0.95f, 0.35f, 0.15f);
-    const float bandRelease = juce::jmap (smoothing, 0.0f, 0.95f, 0.12f, 0.05f);
-    const float rmsReleaseBlock = std::pow (rmsReleasePerSample, numSamples);
+        if (loudness.process (leftData, rightData, numSamples))
+            publishLoudness();
+    }
 
-    const float* leftData = buffer.getReadPointer (0);
-    const float* rightData = activeChannels > 1 ? buffer.getReadPointer (1) : nullptr;
+    {
+        NEONSCOPE_PROFILE_STAGE (profiler, truePeak);
+        NEONSCOPE_TRACE_SCOPE ("True peak");
+        truePeak.process (leftData, rightData, numSamples);
+    }
 
-    float peakLeft = 0.0f;
-    float peakRight = 0.0f;
-    double sumLeft = 0.0;
-    double sumRight = 0.0;
-    double sumLR = 0.0;
-    double sumMid = 0.0;
-    double sumSide = 0.0;
+    {
+        NEONSCOPE_PROFILE_STAGE (profiler, metering);
+        NEONSCOPE_TRACE_SCOPE ("History");
+        levelHistory.process (leftData, rightData, numSamples, loudness.getResults().momentary);
+    }
 
-    for (int i = 0; i < numSamples; ++i)
+    if (numSamples > 0 && activeChannels > 0)
     {
-        const float L = leftData != nullptr ? leftData[i] : 0.0f;
-        const float R = rightData != nullptr ? rightData[i] : L;
+        NEONSCOPE_PROFILE_STAGE (profiler, fft);
+        NEONSCOPE_TRACE_SCOPE ("FFT");
 
-        peakLeft = juce::jmax (peakLeft, std::abs (L));
-        peakRight = juce::jmax (peakRight, std::abs (R));
+        const float fftSmoothing = juce::jmap (settings.smoothing, 0.0f, 0.95f, 0.75f, 0.92f);
 
-        sumLeft += static_cast<double> (L) * L;
-        sumRight += static_cast<double> (R) * R;
-        sumLR += static_cast<double> (L) * R;
+        const bool fftBands = ! settings.bandFilterbank;
 
-        const float mid = 0.5f * (L + R);
-        const float side = 0.5f * (L - R);
-        sumMid += static_cast<double> (mid) * mid;
-        sumSide += static_cast<double> (side) * side;
+        // The FFT still runs in filterbank mode: the curve, spectrogram and
+        // stereo bands come from it. Only the band levels switch source.
+        analysis.pushSpectrum (leftData, rightData, numSamples, [this, fftSmoothing, fftBands] (const AnalysisEngine::Bands& levels)
+        {
+            const auto& stereo = analysis.getStereoBands();
+            auto smooth = [fftSmoothing] (float& value, float target) { value = value * fftSmoothing + target * (1.0f - fftSmoothing); };
+
+            for (size_t band = 0; band < levels.size(); ++band)
+            {
+                if (fftBands)
+                {
+                    auto& level = meterFrame.bands[band];
+                    level = juce::jlimit (0.0f, 1.0f, level * fftSmoothing + levels[band] * (1.0f - fftSmoothing));
+                }
+
+                smooth (meterFrame.bandCorrelation[band], stereo.correlation[band]);
+                smooth (meterFrame.bandWidth[band], stereo.width[band]);
+                smooth (meterFrame.bandBalance[band], stereo.balance[band]);
+            }
+
+            spectrumColumns.publish (analysis.getSpectrumColumn());
+            spectrumFrames.publish (analysis.getSpectrum());
+        });
+
+        // The envelopes do their own smoothing, so the levels are taken as
+        // they are at the end of each sub-block.
+        if (settings.bandFilterbank)
+        {
+            NEONSCOPE_TRACE_SCOPE ("Filterbank");
+            bandFilterbank.process (leftData, rightData, numSamples);
+            bandFilterbank.getLevels (meterFrame.bands.data());
+        }
+
+        if (settings.sidechainLeft != nullptr)
+        {
+            const auto* keyRight = settings.sidechainRight != nullptr ? settings.sidechainRight + startSample : nullptr;
+
+            sidechainComparison.push (leftData, rightData, settings.sidechainLeft + startSample, keyRight, numSamples,
+                                      [this, fftSmoothing] (const SpectralComparison::Result& result)
+            {
+                auto smooth = [fftSmoothing] (float& value, float target) { value = value * fftSmoothing + target * (1.0f - fftSmoothing); };
+
+                for (size_t band = 0; band < result.keyLevels.size(); ++band)
+                {
+                    smooth (meterFrame.sidechainBands[band], result.keyLevels[band]);
+                    smooth (meterFrame.sidechainDifferenceDb[band], result.differenceDb[band]);
+                    smooth (meterFrame.sidechainMasking[band], result.masking[band]);
+                }
+            });
+        }
     }
 
-    const float leftRmsInstant = std::sqrt (sumLeft / juce::jmax (1, numSamples));
-    const float rightRmsInstant = std::sqrt (sumRight / juce::jmax (1, numSamples));
+    return minLimiterGain;
+}
+
+void NeonScopeAudioProcessor::publishMeters (float sensitivity, float smoothing)
+{
+    const auto& meters = analysis.getMeters();
+    const int numSamples = meters.samples;
+
+    const float sensitivityDbOffset = juce::Decibels::gainToDecibels (sensitivity, -120.0f);
+    const float meterAttack = juce::jmap (smoothing, 0.0f, 0.95f, 0.45f, 0.2f);
+    const float meterRelease = juce::jmap (smoothing, 0.0f, 0.95f, 0.08f, 0.03f);
+    const float rmsReleaseBlock = blockCoefficient (rmsReleaseBlockCoefficients, rmsReleasePerSample, numSamples);
+
+    const float leftRmsInstant = meters.getRmsLeft();
+    const float rightRmsInstant = meters.getRmsRight();
 
     auto smoothRms = [rmsReleaseBlock] (float& state, float target)
     {
@@ -831,65 +1303,164 @@ void NeonScopeAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                                            juce::Decibels::gainToDecibels (smoothedRight + epsilon, -120.0f) + sensitivityDbOffset);
     const float leftPeakDb = juce::jlimit (meterFloorDb,
                                            peakCeilingDb,
-                                           juce::Decibels::gainToDecibels (peakLeft + epsilon, -120.0f) + sensitivityDbOffset);
+                                           juce::Decibels::gainToDecibels (meters.peakLeft + epsilon, -120.0f) + sensitivityDbOffset);
     const float rightPeakDb = juce::jlimit (meterFloorDb,
                                             peakCeilingDb,
-                                            juce::Decibels::gainToDecibels (peakRight + epsilon, -120.0f) + sensitivityDbOffset);
+                                            juce::Decibels::gainToDecibels (meters.peakRight + epsilon, -120.0f) + sensitivityDbOffset);
 
     const float leftNorm = normaliseDb (leftRmsDb, meterFloorDb, meterCeilingDb);
     const float rightNorm = normaliseDb (rightRmsDb, meterFloorDb, meterCeilingDb);
 
-    const float leftSmoothedNorm = applyBallistics (currentLeftLevel.load(), leftNorm, meterAttack, meterRelease);
-    const float rightSmoothedNorm = applyBallistics (currentRightLevel.load(), rightNorm, meterAttack, meterRelease);
+    auto& frame = meterFrame;
+    frame.leftLevel = applyBallistics (frame.leftLevel, leftNorm, meterAttack, meterRelease);
+    frame.rightLevel = applyBallistics (frame.rightLevel, rightNorm, meterAttack, meterRelease);
+    frame.leftPeakDb = roundToDecimals (leftPeakDb, 1);
+    frame.rightPeakDb = roundToDecimals (rightPeakDb, 1);
+    frame.leftRmsDb = roundToDecimals (leftRmsDb, 1);
+    frame.rightRmsDb = roundToDecimals (rightRmsDb, 1);
+
+    frame.correlation = meters.getCorrelation();
+    frame.width = meters.getWidth();
+    frame.globalRms = juce::jlimit (0.0f, 1.0f, 0.5f * (frame.leftLevel + frame.rightLevel));
 
-    currentLeftLevel.store (leftSmoothedNorm);
-    currentRightLevel.store (rightSmoothedNorm);
-    currentLeftPeakDb.store (roundToDecimals (leftPeakDb, 1));
-    currentRightPeakDb.store (roundToDecimals (rightPeakDb, 1));
-    currentLeftRmsDb.store (roundToDecimals (leftRmsDb, 1));
-    currentRightRmsDb.store (roundToDecimals (rightRmsDb, 1));
+    publishTruePeak();
+    analysis.resetMeters();
+}
 
-    const double denom = std::sqrt (juce::jmax (static_cast<double> (epsilon), sumLeft * sumRight));
-    const float correlation = denom > 0.0 ? static_cast<float> (sumLR / denom) : 0.0f;
-    correlationValue.store (juce::jlimit (-1.0f, 1.0f, correlation));
+// True peak is a compliance reading of the output, so sensitivity does not apply.
+void NeonScopeAudioProcessor::publishTruePeak()
+{
+    meterFrame.truePeakLeftDb = roundToDecimals (juce::Decibels::gainToDecibels (truePeak.getPeriodPeak (0), -100.0f), 1);
+    meterFrame.truePeakRightDb = roundToDecimals (juce::Decibels::gainToDecibels (truePeak.getPeriodPeak (1), -100.0f), 1);
+    meterFrame.truePeakHoldDb = juce::Decibels::gainToDecibels (truePeak.getHold(), -100.0f);
+    meterFrame.truePeakOvers = truePeak.getOverCount();
+    meterFrameChanged = true;
+    truePeak.resetPeriod();
+}
 
-    const float widthMetric = sumMid > 0.0 ? juce::jlimit (0.0f, 1.0f, static_cast<float> (sumSide / sumMid)) : 0.0f;
-    widthValue.store (widthMetric);
-    globalRmsLevel.store (juce::jlimit (0.0f, 1.0f, 0.5f * (leftSmoothedNorm + rightSmoothedNorm)));
+void NeonScopeAudioProcessor::publishLoudness()
+{
+    const auto& results = loudness.getResults();
+    meterFrame.momentaryLufs = results.momentary;
+    meterFrame.shortTermLufs = results.shortTerm;
+    meterFrame.integratedLufs = results.integrated;
+    meterFrame.loudnessRange = results.range;
+    meterFrameChanged = true;
+}
 
-    if (numSamples > 0 && activeChannels > 0)
+void NeonScopeAudioProcessor::publishFrame() noexcept
+{
+    ++meterFrame.sequence;
+    meterFrames.publish (meterFrame);
+    meterFrameChanged = false;
+}
+
+// Reads the host-rate frames under the transport position and runs them through
+// their own analysis engine; in audition mode they also replace the output.
+void NeonScopeAudioProcessor::processReference (juce::AudioBuffer<float>& buffer,
+                                                const juce::Optional<juce::AudioPlayHead::PositionInfo>& position,
+                                                int referenceMode, float sensitivity, float smoothing)
+{
+    const auto timeInSamples = referenceMode != 0 && position.hasValue() && position->getIsPlaying() ? position->getTimeInSamples()
+                                                                                                      : juce::Optional<juce::int64>();
+
+    if (! timeInSamples.hasValue())
     {
-        const float* monoData = buffer.getReadPointer (0);
-        std::vector<float> monoMix (numSamples);
+        if (meterFrame.referenceActive)
+            clearReferenceDisplay();
 
-        if (activeChannels == 1)
-        {
-            std::copy (monoData, monoData + numSamples, monoMix.begin());
-        }
-        else
+        return;
+    }
+
+    NEONSCOPE_TRACE_SCOPE ("Reference");
+
+    const bool audition = referenceMode == 2;
+    const int numSamples = buffer.getNumSamples();
+    // The buffer also carries the sidechain's channels; audition only replaces
+    // the main output.
+    const int numChannels = getMainBusNumOutputChannels();
+    const float fftSmoothing = juce::jmap (smoothing, 0.0f, 0.95f, 0.75f, 0.92f);
+    auto* left = referenceBuffer.getWritePointer (0);
+    auto* right = referenceBuffer.getWritePointer (1);
+    bool anyAvailable = false;
+
+    for (int startSample = 0; startSample < numSamples; startSample += maxSubBlockSize)
+    {
+        const int count = juce::jmin (maxSubBlockSize, numSamples - startSample);
+        const bool available = referenceTrack.read (*timeInSamples + startSample, left, right, count);
+
+        if (audition)
         {
-            const float* rightData = buffer.getReadPointer (1);
-            for (int i = 0; i < numSamples; ++i)
-                monoMix[i] = (monoData[i] + rightData[i]) * 0.5f;
+            if (numChannels > 1)
+            {
+                buffer.copyFrom (0, startSample, left, count);
+                buffer.copyFrom (1, startSample, right, count);
+            }
+            else if (numChannels == 1)
+            {
+                buffer.copyFrom (0, startSample, left, count, 0.5f);
+                buffer.addFrom (0, startSample, right, count, 0.5f);
+            }
         }
 
-        pushSamplesIntoFifo (fifoBuffer, fifoIndex, nextFFTBlockReady, monoMix.data(), numSamples, fftSize);
+        if (! available)
+            continue;
 
-        if (nextFFTBlockReady)
+        anyAvailable = true;
+        referenceAnalysis.accumulateMeters (left, right, count);
+        referenceAnalysis.pushSpectrum (left, right, count, [this, fftSmoothing] (const AnalysisEngine::Bands& levels)
         {
-            nextFFTBlockReady = false;
-            std::fill (fftData.begin(), fftData.end(), 0.0f);
-            std::copy (fifoBuffer.begin(), fifoBuffer.end(), fftData.begin());
+            for (size_t band = 0; band < levels.size(); ++band)
+            {
+                auto& level = meterFrame.referenceBands[band];
+                level = juce::jlimit (0.0f, 1.0f, level * fftSmoothing + levels[band] * (1.0f - fftSmoothing));
+            }
+        });
+    }
 
-            juce::dsp::WindowingFunction<float> window (fftSize, juce::dsp::WindowingFunction<float>::hann);
-            window.multiplyWithWindowingTable (fftData.data(), fftSize);
+    meterFrame.referenceActive = anyAvailable;
 
-            fft->performFrequencyOnlyForwardTransform (fftData.data());
+    const auto& meters = referenceAnalysis.getMeters();
 
-            const float fftSmoothing = juce::jmap (smoothing, 0.0f, 0.95f, 0.75f, 0.92f);
-            mapFFTBinsToLogBands (fftData, bandLevels, fftSize, currentSampleRate, fftSmoothing);
-        }
-    }
+    if (meters.samples < meterPublishSamples)
+        return;
+
+    // Same release and sensitivity as the live meters, so the two line up.
+    const float release = blockCoefficient (rmsReleaseBlockCoefficients, rmsReleasePerSample, meters.samples);
+    const float sensitivityDbOffset = juce::Decibels::gainToDecibels (sensitivity, -120.0f);
+
+    const auto publish = [&] (float& state, float rms, float& destination)
+    {
+        state = rms >= state ? rms : rms + (state - rms) * release;
+        const float db = juce::Decibels::gainToDecibels (state + epsilon, -120.0f) + sensitivityDbOffset;
+        destination = roundToDecimals (juce::jlimit (meterFloorDb, meterCeilingDb, db), 1);
+    };
+
+    publish (referenceRmsLeftState, meters.getRmsLeft(), meterFrame.referenceLeftRmsDb);
+    publish (referenceRmsRightState, meters.getRmsRight(), meterFrame.referenceRightRmsDb);
+    meterFrameChanged = true;
+    referenceAnalysis.resetMeters();
+}
+
+void NeonScopeAudioProcessor::clearReferenceDisplay()
+{
+    meterFrame.referenceActive = false;
+    meterFrame.referenceLeftRmsDb = meterFloorDb;
+    meterFrame.referenceRightRmsDb = meterFloorDb;
+    meterFrame.referenceBands.fill (0.0f);
+    meterFrameChanged = true;
+}
+
+void NeonScopeAudioProcessor::loadReference (const juce::File& file)
+{
+    parameters.state.setProperty ("referenceFile", file.getFullPathName(), nullptr);
+    referenceTrack.load (file);
+}
+
+void NeonScopeAudioProcessor::clearReference()
+{
+    parameters.state.removeProperty ("referenceFile", nullptr);
+    referenceTrack.clear();
 }
 
 void NeonScopeAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
@@ -903,15 +1474,16 @@ void NeonScopeAudioProcessor::setStateInformation (const void* data, int sizeInB
 {
     if (auto xml = getXmlFromBinary (data, sizeInBytes))
         parameters.replaceState (juce::ValueTree::fromXml (*xml));
-}
 
-std::array<float, NeonScopeAudioProcessor::numBands> NeonScopeAudioProcessor::getBands() const noexcept
-{
-    std::array<float, numBands> values {};
-    for (size_t i = 0; i < values.size(); ++i)
-        values[i] = bandLevels[i].load();
+    const auto referencePath = parameters.state.getProperty ("referenceFile").toString();
+
+    if (referencePath == referenceTrack.getFile().getFullPathName())
+        return;
 
-    return values;
+    if (juce::File::isAbsolutePath (referencePath))
+        referenceTrack.load (juce::File (referencePath));
+    else
+        referenceTrack.clear();
 }
 
 juce::AudioProcessorEditor* NeonScopeAudioProcessor::createEditor()
@@ -1016,6 +1588,18 @@ juce::AudioProcessorValueTreeState::ParameterLayout NeonScopeAudioProcessor::cre
         juce::NormalisableRange<float> { 0.0f, 0.95f, 0.0f, 0.5f },
         0.7f));
 
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        "referenceMode",
+        "Reference",
+        juce::StringArray { "Off", "Overlay", "Audition" },
+        0));
+
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        "bandAnalysis",
+        "Band Analysis",
+        juce::StringArray { "FFT", "Filterbank" },
+        0));
+
     return { params.begin(), params.end() };
 }
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -1,18 +1,43 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "AnalysisEngine.h"
+#include "BandFilterbank.h"
+#include "LevelHistory.h"
+#include "LoudnessMeter.h"
+#include "MeterFrame.h"
+#include "ReferenceTrack.h"
+#include "SampleRing.h"
+#include "SharedTimeSliceThread.h"
+#include "SpectralComparison.h"
+#include "StageProfiler.h"
+#include "TraceRecorder.h"
+#include "TruePeakMeter.h"
 #include <array>
 #include <atomic>
 #include <memory>
 #include <vector>
 
-class NeonScopeAudioProcessor : public juce::AudioProcessor
+class NeonScopeAudioProcessor : public juce::AudioProcessor,
+                                private juce::TimeSliceClient
 {
 public:
-    static constexpr int numBands = 16;
+    static constexpr int numBands = AnalysisEngine::numBands;
+
+    // Estimated heap usage per subsystem, in bytes.
+    struct MemoryFootprint
+    {
+        size_t oversampling = 0;
+        size_t interpolation = 0;
+        size_t processingBuffers = 0;
+        size_t analysis = 0;
+        size_t history = 0;
+
+        size_t total() const noexcept { return oversampling + interpolation + processingBuffers + analysis + history; }
+    };
 
     NeonScopeAudioProcessor();
-    ~NeonScopeAudioProcessor() override = default;
+    ~NeonScopeAudioProcessor() override;
 
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -41,46 +66,150 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
-    float getLeftLevel() const noexcept { return currentLeftLevel.load(); }
-    float getRightLevel() const noexcept { return currentRightLevel.load(); }
-    float getLeftPeakDb() const noexcept { return currentLeftPeakDb.load(); }
-    float getRightPeakDb() const noexcept { return currentRightPeakDb.load(); }
-    float getLeftRmsDb() const noexcept { return currentLeftRmsDb.load(); }
-    float getRightRmsDb() const noexcept { return currentRightRmsDb.load(); }
-    float getCorrelationValue() const noexcept { return correlationValue.load(); }
-    float getWidthValue() const noexcept { return widthValue.load(); }
-    float getAutoGainDb() const noexcept { return autoGainDisplayDb.load(); }
-    float getLimiterReductionDb() const noexcept { return limiterReductionDb.load(); }
-    float getGlobalRmsLevel() const noexcept { return globalRmsLevel.load(); }
+    // Meter frames are published once per block that produced new readings.
+    // Both calls are for a single reader, normally the editor's timer.
+    using MeterFrameExchange = FrameExchange<MeterFrame, 128, MeterFrame::Fold>;
+    bool readMeterFrame (MeterFrame& destination) noexcept { return meterFrames.readLatest (destination); }
+    MeterFrameExchange& getMeterFrames() noexcept { return meterFrames; }
+
+    // One column per analysis frame for the spectrogram, queued for a single reader.
+    using SpectrumColumnExchange = FrameExchange<AnalysisEngine::SpectrumColumn, 32>;
+    SpectrumColumnExchange& getSpectrumColumns() noexcept { return spectrumColumns; }
+
+    // Newest full-resolution spectrum, for the curve.
+    TripleBuffer<AnalysisEngine::Spectrum>& getSpectrumFrames() noexcept { return spectrumFrames; }
+
+    // Every output sample, for the goniometer; read from a single thread.
+    SampleRing& getStereoSamples() noexcept { return stereoSamples; }
+
+    // Level and loudness over time; read from a single thread, normally the editor's.
+    const LevelHistory& getLevelHistory() const noexcept { return levelHistory; }
+
+    void resetLoudness() noexcept { loudnessResetRequested.store (true); }
     const std::array<float, 5>& getMeterTicks() const noexcept { return meterTicksDb; }
-    std::array<float, numBands> getBands() const noexcept;
+    MemoryFootprint getMemoryFootprint() const;
+
+    // Reference track. load/clear are message-thread calls; the path is kept
+    // in the state so the reference comes back with the session.
+    void loadReference (const juce::File& file);
+    void clearReference();
+    const ReferenceTrack& getReferenceTrack() const noexcept { return referenceTrack; }
 
     juce::AudioProcessorValueTreeState& getValueTreeState() noexcept { return parameters; }
 
+   #if NEONSCOPE_PROFILING
+    StageProfiler& getProfiler() noexcept { return profiler; }
+   #endif
+
 private:
+    // Everything only the processing modes need. Built off the audio thread with
+    // just the capabilities the current settings require and published through
+    // activeChain; the audio thread never allocates or frees one.
+    struct ProcessingChain
+    {
+        enum Capability : juce::uint32
+        {
+            core          = 1u << 0,
+            oversample2x  = 1u << 1,
+            oversample4x  = 1u << 2,
+            fractional    = 1u << 3
+        };
+
+        juce::uint32 capabilities = 0;
+        size_t oversamplingBytes = 0;
+        size_t interpolationBytes = 0;
+        size_t bufferBytes = 0;
+        std::unique_ptr<juce::dsp::Oversampling<float>> oversampler2x;
+        std::unique_ptr<juce::dsp::Oversampling<float>> oversampler4x;
+        std::vector<juce::LagrangeInterpolator> fractionalUpsamplers;
+        std::vector<juce::LagrangeInterpolator> fractionalDownsamplers;
+        juce::AudioBuffer<float> oversamplingBuffer;
+        juce::AudioBuffer<float> bandListenBuffer;
+        juce::AudioBuffer<float> dryBuffer;
+
+        void reset();
+    };
+
+    // Builds processing chains for every instance in the process.
+    struct PreparerThread
+    {
+        static constexpr const char* name = "NeonScope Preparer";
+    };
+
+    struct ParameterHandles
+    {
+        std::atomic<float>* mode = nullptr;
+        std::atomic<float>* filterType = nullptr;
+        std::atomic<float>* cutoff = nullptr;
+        std::atomic<float>* resonance = nullptr;
+        std::atomic<float>* drive = nullptr;
+        std::atomic<float>* satMode = nullptr;
+        std::atomic<float>* width = nullptr;
+        std::atomic<float>* mix = nullptr;
+        std::atomic<float>* outputTrim = nullptr;
+        std::atomic<float>* oversampling = nullptr;
+        std::atomic<float>* sensitivity = nullptr;
+        std::atomic<float>* smoothing = nullptr;
+        std::atomic<float>* autoGain = nullptr;
+        std::atomic<float>* limiter = nullptr;
+        std::atomic<float>* bandListen = nullptr;
+        std::atomic<float>* monitorMode = nullptr;
+        std::atomic<float>* referenceMode = nullptr;
+        std::atomic<float>* bandAnalysis = nullptr;
+    };
+
+    struct BlockSettings;
+
     static constexpr std::array<float, 5> meterTicksDb { -60.0f, -30.0f, -12.0f, -6.0f, 0.0f };
-    static constexpr int fftOrder = 11;
-    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int minSubBlockSize = 64;
+    static constexpr int maxSubBlockSize = 512;
+    static constexpr int meterPublishSamples = 64;
+
+    // About a third of a second at 192 kHz, several editor ticks even when idle.
+    static constexpr int stereoRingSamples = 1 << 16;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    juce::AudioProcessorValueTreeState parameters;
+    static juce::uint32 capabilitiesFor (int mode, int oversamplingChoice);
 
-    std::atomic<float> currentLeftLevel { 0.0f };
-    std::atomic<float> currentRightLevel { 0.0f };
-    std::atomic<float> currentLeftPeakDb { -100.0f };
-    std::atomic<float> currentRightPeakDb { -100.0f };
-    std::atomic<float> currentLeftRmsDb { -100.0f };
-    std::atomic<float> currentRightRmsDb { -100.0f };
-    std::atomic<float> correlationValue { 0.0f };
-    std::atomic<float> widthValue { 0.0f };
-    std::atomic<float> autoGainDisplayDb { 0.0f };
-    std::atomic<float> limiterReductionDb { 0.0f };
-    std::atomic<float> globalRmsLevel { 0.0f };
-    std::array<std::atomic<float>, numBands> bandLevels {};
+    float processSubBlock (juce::AudioBuffer<float>& buffer, const BlockSettings& settings, int startSample);
+    void publishMeters (float sensitivity, float smoothing);
+    void publishLoudness();
+    void publishTruePeak();
+    void publishFrame() noexcept;
+    void processReference (juce::AudioBuffer<float>& buffer, const juce::Optional<juce::AudioPlayHead::PositionInfo>& position,
+                           int referenceMode, float sensitivity, float smoothing);
+    void clearReferenceDisplay();
+
+    int useTimeSlice() override;
+    std::unique_ptr<ProcessingChain> buildChain (juce::uint32 capabilities) const;
+    void publishChain (std::unique_ptr<ProcessingChain> chain);
+    void reclaimRetiredChain();
+
+    juce::AudioProcessorValueTreeState parameters;
+    ParameterHandles parameterHandles;
+
+    // Built up by the audio thread (and prepareToPlay) and copied out whole
+    // by publishFrame(); nothing else reads it.
+    MeterFrame meterFrame;
+    bool meterFrameChanged = false;
+    MeterFrameExchange meterFrames;
+    SpectrumColumnExchange spectrumColumns;
+    TripleBuffer<AnalysisEngine::Spectrum> spectrumFrames;
+    SampleRing stereoSamples { stereoRingSamples };
+    std::atomic<bool> loudnessResetRequested { false };
     juce::dsp::StateVariableTPTFilter<float> filterL;
     juce::dsp::StateVariableTPTFilter<float> filterR;
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler2x;
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler4x;
+    juce::SharedResourcePointer<SharedTimeSliceThread<PreparerThread>> preparer;
+    juce::CriticalSection chainLock;
+    std::unique_ptr<ProcessingChain> ownedChain;
+    std::unique_ptr<ProcessingChain> retiredChain;
+    std::atomic<ProcessingChain*> activeChain { nullptr };
+    std::atomic<juce::uint32> requestedCapabilities { 0 };
+    std::atomic<juce::uint32> completedBlocks { 0 };
+    juce::uint32 retiredAtBlock = 0;
+    juce::uint32 preparedBlockSize = 0;
+    int preparedChannels = 0;
+    bool chainSpecReady = false;
     double currentSampleRate = 44100.0;
     float driveState = 2.0f;
     float mixState = 1.0f;
@@ -93,15 +222,25 @@ private:
     float autoGainSmoothingPerSample = 0.0f;
     float limiterReleasePerSample = 0.0f;
     float limiterGain = 1.0f;
-    std::vector<juce::LagrangeInterpolator> fractionalUpsamplers;
-    std::vector<juce::LagrangeInterpolator> fractionalDownsamplers;
-    juce::AudioBuffer<float> oversamplingBuffer;
-    juce::AudioBuffer<float> bandListenBuffer;
-    std::unique_ptr<juce::dsp::FFT> fft;
-    std::vector<float> fftData;
-    std::vector<float> fifoBuffer;
-    int fifoIndex = 0;
-    bool nextFFTBlockReady = false;
+    float filterCutoffState = -1.0f;
+    float filterResonanceState = -1.0f;
+    std::array<float, maxSubBlockSize + 1> rmsReleaseBlockCoefficients {};
+    std::array<float, maxSubBlockSize + 1> autoGainBlockCoefficients {};
+    AnalysisEngine analysis;
+    LoudnessMeter loudness;
+    TruePeakMeter truePeak;
+    LevelHistory levelHistory;
+    ReferenceTrack referenceTrack;
+    AnalysisEngine referenceAnalysis;
+    SpectralComparison sidechainComparison;
+    BandFilterbank bandFilterbank;
+    juce::AudioBuffer<float> referenceBuffer;
+    float referenceRmsLeftState = 0.0f;
+    float referenceRmsRightState = 0.0f;
+
+   #if NEONSCOPE_PROFILING
+    StageProfiler profiler;
+   #endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NeonScopeAudioProcessor)
 };
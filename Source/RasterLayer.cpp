@@ -0,0 +1,323 @@
+#include "RasterLayer.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Samples per pixel side when measuring disc coverage for the masks.
+    constexpr int maskOversampling = 8;
+
+    // The blends multiply by 0..256 and shift down by 8, so full coverage
+    // lands exactly on the colour.
+    inline int toBlendAlpha (int alpha) noexcept  { return alpha + (alpha >> 7); }
+}
+
+bool RasterLayer::prepare (const juce::Image& background, float newScale, juce::Rectangle<float> area)
+{
+    const auto bounds = (area * newScale).getSmallestIntegerContainer().getIntersection (background.getBounds());
+
+    if (bounds.isEmpty())
+    {
+        release();
+        return false;
+    }
+
+    if (newScale != scale)
+        masks.clear();
+
+    scale = newScale;
+    physicalBounds = bounds;
+
+    // A software RGB image whatever the backdrop is, so the pixel layout is
+    // known: three bytes per pixel, rows lineStride apart.
+    base = juce::Image (juce::Image::RGB, bounds.getWidth(), bounds.getHeight(), false, juce::SoftwareImageType());
+    {
+        juce::Graphics g (base);
+        g.drawImageAt (background, -bounds.getX(), -bounds.getY());
+    }
+    pixels = base.createCopy();
+
+    // Software pixel data doesn't move for the lifetime of the image.
+    const juce::Image::BitmapData baseData (base, juce::Image::BitmapData::readOnly);
+    const juce::Image::BitmapData pixelData (pixels, juce::Image::BitmapData::readWrite);
+    jassert (pixelData.pixelStride == 3 && pixelData.lineStride == baseData.lineStride);
+
+    source = baseData.data;
+    data = pixelData.data;
+    lineStride = pixelData.lineStride;
+    return true;
+}
+
+void RasterLayer::release()
+{
+    base = {};
+    pixels = {};
+    source = nullptr;
+    data = nullptr;
+}
+
+void RasterLayer::begin()
+{
+    if (data != nullptr)
+        std::memcpy (data, source, (size_t) (lineStride * physicalBounds.getHeight()));
+}
+
+void RasterLayer::blit (juce::Graphics& g) const
+{
+    if (data == nullptr)
+        return;
+
+    // Whole physical pixels, so the renderer copies rows instead of resampling.
+    g.drawImageTransformed (pixels, juce::AffineTransform::translation ((float) physicalBounds.getX(), (float) physicalBounds.getY())
+                                                          .scaled (1.0f / scale));
+}
+
+juce::Rectangle<float> RasterLayer::toPhysical (juce::Rectangle<float> area) const noexcept
+{
+    return (area * scale).translated ((float) -physicalBounds.getX(), (float) -physicalBounds.getY());
+}
+
+// ─── Shapes ─────────────────────────────────────────────────────────────────
+
+void RasterLayer::fillRect (juce::Rectangle<float> area, juce::Colour colour)
+{
+    fillRoundedRect (area, 0.0f, colour);
+}
+
+void RasterLayer::fillRoundedRect (juce::Rectangle<float> area, float cornerRadius, juce::Colour colour)
+{
+    if (data == nullptr || colour.getAlpha() == 0)
+        return;
+
+    const auto r = toPhysical (area);
+
+    if (r.isEmpty())
+        return;
+
+    // The corners are the quadrants of a disc mask two radii across.
+    const int radius = juce::jmin (juce::roundToInt (cornerRadius * scale),
+                                   (int) (r.getWidth() * 0.5f), (int) (r.getHeight() * 0.5f));
+    const Mask* corner = radius > 0 ? &discMasks ((float) (2 * radius)).phases[0] : nullptr;
+
+    const auto pattern = makePattern (colour);
+    const int top = (int) std::floor (r.getY());
+    const int bottom = (int) std::ceil (r.getBottom());
+
+    for (int y = juce::jmax (0, top); y < juce::jmin (physicalBounds.getHeight(), bottom); ++y)
+    {
+        const float rowCoverage = juce::jmin (r.getBottom(), (float) (y + 1)) - juce::jmax (r.getY(), (float) y);
+        const int fromEdge = juce::jmin (y - top, bottom - 1 - y);
+        const juce::uint8* cornerRow = corner != nullptr && fromEdge < radius
+                                         ? corner->coverage.data() + fromEdge * corner->size
+                                         : nullptr;
+
+        fillRow (y, r.getX(), r.getRight(), juce::roundToInt ((float) colour.getAlpha() * rowCoverage),
+                 pattern, cornerRow, radius);
+    }
+}
+
+void RasterLayer::fillDisc (juce::Point<float> centre, float diameter, juce::Colour colour)
+{
+    if (data == nullptr || colour.getAlpha() == 0 || diameter <= 0.0f)
+        return;
+
+    const auto& discs = discMasks (diameter * scale);
+    const auto topLeft = toPhysical (juce::Rectangle<float> (diameter, diameter).withCentre (centre)).getTopLeft();
+
+    // In quarter pixels: the whole pixel above the two low bits, the mask phase in them.
+    const int quarterX = juce::roundToInt (topLeft.x * 4.0f);
+    const int quarterY = juce::roundToInt (topLeft.y * 4.0f);
+    const auto& mask = discs.phases[(size_t) ((quarterY & 3) * 4 + (quarterX & 3))];
+    const int left = quarterX >> 2;
+    const int top = quarterY >> 2;
+
+    const auto pattern = makePattern (colour);
+    const int alpha = colour.getAlpha();
+
+    for (int j = 0; j < mask.size; ++j)
+    {
+        const int y = top + j;
+
+        if (y < 0 || y >= physicalBounds.getHeight())
+            continue;
+
+        const auto* coverage = mask.coverage.data() + j * mask.size;
+
+        for (int i = 0; i < mask.size; ++i)
+        {
+            const int x = left + i;
+
+            if (coverage[i] != 0 && x >= 0 && x < physicalBounds.getWidth())
+                blendPixel (pixelAt (x, y), pattern.data(), toBlendAlpha (alpha * coverage[i] / 255));
+        }
+    }
+}
+
+void RasterLayer::fillArrow (juce::Point<float> tip, float length, float halfHeight, juce::Colour colour)
+{
+    if (data == nullptr || colour.getAlpha() == 0)
+        return;
+
+    const auto r = toPhysical ({ tip.x - length, tip.y - halfHeight, length, halfHeight * 2.0f });
+    const float middle = r.getCentreY();
+    const float half = r.getHeight() * 0.5f;
+    const auto pattern = makePattern (colour);
+
+    if (half <= 0.0f)
+        return;
+
+    for (int y = juce::jmax (0, (int) std::floor (r.getY())); y < juce::jmin (physicalBounds.getHeight(), (int) std::ceil (r.getBottom())); ++y)
+    {
+        const float distance = std::abs ((float) y + 0.5f - middle);
+
+        if (distance < half)
+            fillRow (y, r.getX(), r.getX() + r.getWidth() * (1.0f - distance / half), colour.getAlpha(), pattern, nullptr, 0);
+    }
+}
+
+void RasterLayer::fillRow (int y, float left, float right, int alpha, const Pattern& pattern,
+                           const juce::uint8* cornerRow, int radius) noexcept
+{
+    if (alpha <= 0 || right <= left)
+        return;
+
+    const int first = (int) std::floor (left);
+    const int end = (int) std::ceil (right);
+    const int width = physicalBounds.getWidth();
+
+    // The ends, and the corner columns if any, go pixel by pixel; the rest
+    // is one span at full coverage.
+    const int edge = cornerRow != nullptr ? juce::jmax (1, radius) : 1;
+    const int spanStart = juce::jmin (end, first + edge);
+    const int spanEnd = juce::jmax (spanStart, end - edge);
+
+    auto blendEdge = [&] (int x)
+    {
+        if (x < 0 || x >= width)
+            return;
+
+        const float columnCoverage = juce::jmin (right, (float) (x + 1)) - juce::jmax (left, (float) x);
+        int coverage = juce::roundToInt ((float) alpha * columnCoverage);
+
+        if (cornerRow != nullptr)
+        {
+            const int fromEdge = juce::jmin (x - first, end - 1 - x);
+
+            if (fromEdge < radius)
+                coverage = coverage * cornerRow[fromEdge] / 255;
+        }
+
+        blendPixel (pixelAt (x, y), pattern.data(), toBlendAlpha (coverage));
+    };
+
+    for (int x = first; x < spanStart; ++x)
+        blendEdge (x);
+
+    for (int x = spanEnd; x < end; ++x)
+        blendEdge (x);
+
+    const int spanFrom = juce::jmax (0, spanStart);
+    const int spanTo = juce::jmin (width, spanEnd);
+
+    if (spanTo > spanFrom)
+        blendSpan (pixelAt (spanFrom, y), spanTo - spanFrom, pattern, toBlendAlpha (alpha));
+}
+
+// ─── Pixels ─────────────────────────────────────────────────────────────────
+
+RasterLayer::Pattern RasterLayer::makePattern (juce::Colour colour)
+{
+    // Straight, not premultiplied: the alpha is applied by the blend.
+    juce::PixelRGB pixel;
+    pixel.set (colour.withAlpha (1.0f).getPixelARGB());
+
+    Pattern pattern;
+    for (size_t i = 0; i < (size_t) patternPixels; ++i)
+        std::memcpy (pattern.data() + i * 3, &pixel, 3);
+
+    return pattern;
+}
+
+void RasterLayer::blendPixel (juce::uint8* pixel, const juce::uint8* colour, int alpha) noexcept
+{
+    for (int i = 0; i < 3; ++i)
+        pixel[i] = (juce::uint8) (pixel[i] + (((colour[i] - pixel[i]) * alpha) >> 8));
+}
+
+// The row is treated as bytes in 16-byte chunks, each blended against the
+// matching 16 bytes of the pattern. A fixed-length loop over uint8 with no
+// dependence between lanes is what GCC, Clang and MSVC vectorise to one
+// SSE2 or NEON register per chunk, without per-target code here.
+void RasterLayer::blendSpan (juce::uint8* row, int numPixels, const Pattern& pattern, int alpha) noexcept
+{
+    constexpr int chunkBytes = 16;
+    constexpr int patternBytes = patternPixels * 3;
+
+    int remaining = numPixels * 3;
+    int offset = 0;
+
+    for (; remaining >= chunkBytes; remaining -= chunkBytes, row += chunkBytes)
+    {
+        const auto* colour = pattern.data() + offset;
+
+        for (int i = 0; i < chunkBytes; ++i)
+            row[i] = (juce::uint8) (row[i] + (((colour[i] - row[i]) * alpha) >> 8));
+
+        offset = (offset + chunkBytes) % patternBytes;
+    }
+
+    const auto* colour = pattern.data() + offset;
+
+    for (int i = 0; i < remaining; ++i)
+        row[i] = (juce::uint8) (row[i] + (((colour[i] - row[i]) * alpha) >> 8));
+}
+
+// Built on first use for each diameter, so at most a handful per scale: the
+// hold dot, the correlation indicator and the corner radii.
+const RasterLayer::DiscMasks& RasterLayer::discMasks (float diameter)
+{
+    for (const auto& discs : masks)
+        if (std::abs (discs.diameter - diameter) < 0.01f)
+            return discs;
+
+    auto& discs = masks.emplace_back();
+    discs.diameter = diameter;
+
+    const float radius = diameter * 0.5f;
+    const int size = (int) std::ceil (diameter + 0.75f);
+    constexpr float step = 1.0f / (float) maskOversampling;
+
+    for (int phase = 0; phase < (int) discs.phases.size(); ++phase)
+    {
+        auto& mask = discs.phases[(size_t) phase];
+        mask.size = size;
+        mask.coverage.resize ((size_t) (size * size));
+
+        const float centreX = (float) (phase & 3) * 0.25f + radius;
+        const float centreY = (float) (phase >> 2) * 0.25f + radius;
+
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                int inside = 0;
+
+                for (int sy = 0; sy < maskOversampling; ++sy)
+                {
+                    const float dy = (float) y + ((float) sy + 0.5f) * step - centreY;
+
+                    for (int sx = 0; sx < maskOversampling; ++sx)
+                    {
+                        const float dx = (float) x + ((float) sx + 0.5f) * step - centreX;
+                        inside += dx * dx + dy * dy <= radius * radius ? 1 : 0;
+                    }
+                }
+
+                mask.coverage[(size_t) (y * size + x)] = (juce::uint8) (inside * 255 / (maskOversampling * maskOversampling));
+            }
+        }
+    }
+
+    return discs;
+}
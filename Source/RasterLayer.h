@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// A small software bitmap over one area of the editor, for the shapes that
+// move every frame: meter fills, peak lines, hold dots and the correlation
+// indicator. Shapes are blended straight into the pixels: spans of full
+// coverage go through a fixed-width loop the compiler vectorises, edges get
+// their coverage from the fractional position, and discs and rounded corners
+// from anti-aliased masks built once per size. Each frame starts from a copy
+// of the chrome under the area and ends with one 1:1 blit.
+//
+// Message thread only. Coordinates are editor (logical) pixels.
+class RasterLayer
+{
+public:
+    // Copies the chrome under area out of background, which is the editor's
+    // backdrop rendered at scale. Returns false, and leaves the layer unusable,
+    // if there is nothing to copy.
+    bool prepare (const juce::Image& background, float scale, juce::Rectangle<float> area);
+    void release();
+    bool isReady() const noexcept  { return data != nullptr; }
+
+    // Restores the chrome, ready for this frame's shapes.
+    void begin();
+
+    void fillRect (juce::Rectangle<float>, juce::Colour);
+    void fillRoundedRect (juce::Rectangle<float>, float cornerRadius, juce::Colour);
+    void fillDisc (juce::Point<float> centre, float diameter, juce::Colour);
+
+    // A triangle pointing right, with its tip at tip.
+    void fillArrow (juce::Point<float> tip, float length, float halfHeight, juce::Colour);
+
+    void blit (juce::Graphics&) const;
+
+private:
+    // Coverage of a disc, 0..255, at one quarter-pixel offset.
+    struct Mask
+    {
+        int size = 0;
+        std::vector<juce::uint8> coverage;   // size * size, row-major
+    };
+
+    struct DiscMasks
+    {
+        float diameter = 0.0f;
+        std::array<Mask, 16> phases;         // [y quarter * 4 + x quarter]
+    };
+
+    // The colour's bytes repeated until the pattern is a whole number of
+    // 16-byte registers as well as whole pixels.
+    static constexpr int patternPixels = 16;
+    using Pattern = std::array<juce::uint8, patternPixels * 3>;
+
+    const DiscMasks& discMasks (float physicalDiameter);
+    static Pattern makePattern (juce::Colour);
+
+    // Fills one pixel row from left to right, with the ends anti-aliased and,
+    // for rounded corners, the first and last radius pixels scaled by
+    // cornerRow. alpha is 0..255.
+    void fillRow (int y, float left, float right, int alpha, const Pattern&,
+                  const juce::uint8* cornerRow, int radius) noexcept;
+    static void blendSpan (juce::uint8* row, int numPixels, const Pattern&, int alpha) noexcept;
+    static void blendPixel (juce::uint8* pixel, const juce::uint8* colour, int alpha) noexcept;
+
+    juce::Rectangle<float> toPhysical (juce::Rectangle<float>) const noexcept;
+    juce::uint8* pixelAt (int x, int y) const noexcept  { return data + y * lineStride + x * 3; }
+
+    juce::Image base, pixels;
+    juce::Rectangle<int> physicalBounds;     // of the layer, in the backdrop
+    float scale = 1.0f;
+    const juce::uint8* source = nullptr;   // base's pixels
+    juce::uint8* data = nullptr;           // pixels' pixels
+    int lineStride = 0;
+
+    std::vector<DiscMasks> masks;
+};
@@ -0,0 +1,403 @@
+#include "ReferenceTrack.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    constexpr double mapWindowSeconds = 10.0;
+    constexpr int maxChunksPerSlice = 8;
+
+    // Decoded copies live in the temp folder, keyed by path, size and date so
+    // an edited file is decoded again.
+    juce::File getCacheFile (const juce::File& file)
+    {
+        const auto key = file.getFullPathName() + juce::String (file.getSize())
+                       + juce::String (file.getLastModificationTime().toMilliseconds());
+
+        return juce::File::getSpecialLocation (juce::File::tempDirectory)
+                   .getChildFile ("NeonScope")
+                   .getChildFile ("References")
+                   .getChildFile (file.getFileNameWithoutExtension() + "-" + juce::String::toHexString (key.hashCode64()) + ".wav");
+    }
+}
+
+// ─── Source ───────────────────────────────────────────────────────────────────
+
+// A mapped file and the resampling chain that turns it into host-rate frames.
+// Created on whichever thread opened it, then owned by the producer.
+struct ReferenceTrack::Source
+{
+    explicit Source (juce::MemoryMappedAudioFormatReader* mappedReader)
+        : reader (mappedReader), readerSource (mappedReader, false), resampler (&readerSource, false, 2) {}
+
+    double getLengthSeconds() const noexcept  { return static_cast<double> (reader->lengthInSamples) / reader->sampleRate; }
+
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader;
+    juce::AudioFormatReaderSource readerSource;
+    juce::ResamplingAudioSource resampler;
+};
+
+// ─── Decoding ─────────────────────────────────────────────────────────────────
+
+// Formats that cannot be mapped are decoded once to a float WAV, which is then
+// mapped like any other reference.
+class ReferenceTrack::DecodeThread : public juce::Thread
+{
+public:
+    DecodeThread (ReferenceTrack& owner, const juce::File& source, const juce::File& cache)
+        : juce::Thread ("NeonScope Reference Decode"), track (owner), sourceFile (source), cacheFile (cache)
+    {
+        formats.registerBasicFormats();
+    }
+
+    ~DecodeThread() override  { stopThread (4000); }
+
+    void run() override
+    {
+        if (! cacheFile.existsAsFile() && ! decode())
+        {
+            if (! threadShouldExit())
+                track.status.store (Status::failed);
+
+            return;
+        }
+
+        auto mapped = openMapped (cacheFile, formats);
+
+        if (threadShouldExit())
+            return;
+
+        if (mapped == nullptr)
+        {
+            track.status.store (Status::failed);
+            return;
+        }
+
+        track.setPendingSource (std::move (mapped));
+        track.status.store (Status::ready);
+    }
+
+private:
+    bool decode()
+    {
+        const std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (sourceFile));
+
+        if (reader == nullptr || reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0)
+            return false;
+
+        const auto partialFile = cacheFile.withFileExtension ("partial");
+        cacheFile.getParentDirectory().createDirectory();
+        partialFile.deleteFile();
+
+        auto stream = partialFile.createOutputStream();
+
+        if (stream == nullptr)
+            return false;
+
+        const auto numChannels = juce::jmin (2u, reader->numChannels);
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (stream.get(), reader->sampleRate,
+                                                                              numChannels, 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        stream.release();
+
+        constexpr int blockSize = 1 << 16;
+        juce::AudioBuffer<float> buffer (static_cast<int> (numChannels), blockSize);
+
+        for (juce::int64 position = 0; position < reader->lengthInSamples; position += blockSize)
+        {
+            if (threadShouldExit())
+            {
+                writer.reset();
+                partialFile.deleteFile();
+                return false;
+            }
+
+            const int count = static_cast<int> (juce::jmin<juce::int64> (blockSize, reader->lengthInSamples - position));
+            reader->read (&buffer, 0, count, position, true, numChannels > 1);
+
+            if (! writer->writeFromAudioSampleBuffer (buffer, 0, count))
+            {
+                writer.reset();
+                partialFile.deleteFile();
+                return false;
+            }
+        }
+
+        writer.reset();
+        return partialFile.moveFileTo (cacheFile);
+    }
+
+    ReferenceTrack& track;
+    const juce::File sourceFile;
+    const juce::File cacheFile;
+    juce::AudioFormatManager formats;
+};
+
+// ─── ReferenceTrack ───────────────────────────────────────────────────────────
+
+ReferenceTrack::ReferenceTrack()
+{
+    formats.registerBasicFormats();
+    chunkBuffer.setSize (2, chunkSize);
+    streamer->thread.addTimeSliceClient (this);
+}
+
+ReferenceTrack::~ReferenceTrack()
+{
+    decoder.reset();
+    streamer->thread.removeTimeSliceClient (this);
+}
+
+void ReferenceTrack::load (const juce::File& newFile)
+{
+    decoder.reset();
+    file = newFile;
+
+    if (! ringReady.load (std::memory_order_acquire))
+    {
+        ringLeft.assign ((size_t) ringSize, 0.0f);
+        ringRight.assign ((size_t) ringSize, 0.0f);
+        ringReady.store (true, std::memory_order_release);
+    }
+
+    if (auto mapped = openMapped (newFile, formats))
+    {
+        setPendingSource (std::move (mapped));
+        status.store (Status::ready);
+        return;
+    }
+
+    setPendingSource (nullptr);
+
+    if (! newFile.existsAsFile())
+    {
+        status.store (Status::failed);
+        return;
+    }
+
+    status.store (Status::decoding);
+    decoder = std::make_unique<DecodeThread> (*this, newFile, getCacheFile (newFile));
+    decoder->startThread();
+}
+
+void ReferenceTrack::clear()
+{
+    decoder.reset();
+    file = juce::File();
+    setPendingSource (nullptr);
+    status.store (Status::empty);
+}
+
+juce::File ReferenceTrack::getFile() const
+{
+    return file;
+}
+
+void ReferenceTrack::prepare (double hostSampleRate) noexcept
+{
+    hostRate.store (hostSampleRate);
+    expectedPosition = -1;
+}
+
+bool ReferenceTrack::read (juce::int64 position, float* left, float* right, int numSamples) noexcept
+{
+    if (ringReady.load (std::memory_order_acquire))
+    {
+        // Any discontinuity is a seek: publish where we are, then the request.
+        if (position != expectedPosition)
+        {
+            readPosition.store (position, std::memory_order_release);
+            seekTarget.store (position, std::memory_order_relaxed);
+            seekGeneration.store (++requestedGeneration, std::memory_order_release);
+        }
+
+        expectedPosition = position + numSamples;
+
+        const auto epoch = sourceEpoch.load (std::memory_order_acquire);
+        bool available = (epoch & 1) == 0
+                      && acknowledgedGeneration.load (std::memory_order_acquire) == requestedGeneration
+                      && position + numSamples <= writePosition.load (std::memory_order_acquire);
+
+        if (available)
+        {
+            const int start = static_cast<int> (position & (ringSize - 1));
+            const int first = juce::jmin (numSamples, ringSize - start);
+
+            std::copy_n (ringLeft.data() + start, first, left);
+            std::copy_n (ringRight.data() + start, first, right);
+            std::copy_n (ringLeft.data(), numSamples - first, left + first);
+            std::copy_n (ringRight.data(), numSamples - first, right + first);
+
+            // The producer restarting mid-copy means these frames may be torn.
+            std::atomic_thread_fence (std::memory_order_acquire);
+            available = sourceEpoch.load (std::memory_order_relaxed) == epoch;
+        }
+
+        readPosition.store (position + numSamples, std::memory_order_release);
+
+        if (available)
+            return true;
+    }
+
+    juce::FloatVectorOperations::clear (left, numSamples);
+    juce::FloatVectorOperations::clear (right, numSamples);
+    return false;
+}
+
+// ─── Producer ─────────────────────────────────────────────────────────────────
+
+int ReferenceTrack::useTimeSlice()
+{
+    adoptPendingSource();
+
+    if (source == nullptr)
+        return 50;
+
+    const double rate = hostRate.load();
+
+    if (rate != producerRate)
+    {
+        producerRate = rate;
+        source->resampler.setResamplingRatio (source->reader->sampleRate / rate);
+        source->resampler.prepareToPlay (chunkSize, rate);
+        restartAt (readPosition.load (std::memory_order_acquire));
+    }
+
+    const auto generation = seekGeneration.load (std::memory_order_acquire);
+
+    if (generation != handledGeneration)
+    {
+        handledGeneration = generation;
+        restartAt (seekTarget.load (std::memory_order_relaxed));
+        acknowledgedGeneration.store (generation, std::memory_order_release);
+    }
+    else if (writePosition.load (std::memory_order_relaxed) < readPosition.load (std::memory_order_acquire))
+    {
+        // The audio thread outran us; resume where it is rather than catch up.
+        restartAt (readPosition.load (std::memory_order_acquire));
+    }
+
+    for (int chunk = 0; chunk < maxChunksPerSlice; ++chunk)
+    {
+        const auto write = writePosition.load (std::memory_order_relaxed);
+        const auto space = readPosition.load (std::memory_order_acquire) + ringSize - write;
+
+        if (space < chunkSize || source->readerSource.getNextReadPosition() >= source->reader->lengthInSamples)
+            return 10;
+
+        fillChunk (write);
+
+        if (seekGeneration.load (std::memory_order_relaxed) != handledGeneration)
+            return 0;
+    }
+
+    return 0;
+}
+
+void ReferenceTrack::adoptPendingSource()
+{
+    std::unique_ptr<Source> adopted;
+
+    {
+        const juce::ScopedLock sl (pendingLock);
+
+        if (! std::exchange (pendingChange, false))
+            return;
+
+        adopted = std::move (pendingSource);
+    }
+
+    // The previous source, and its mapping, is released here rather than on
+    // the thread that replaced it.
+    source = std::move (adopted);
+    producerRate = 0.0;
+
+    if (source == nullptr)
+        restartAt (readPosition.load (std::memory_order_acquire));
+}
+
+void ReferenceTrack::restartAt (juce::int64 hostPosition)
+{
+    // An odd epoch tells the audio thread the ring is being rewritten.
+    const auto epoch = sourceEpoch.load (std::memory_order_relaxed);
+    sourceEpoch.store (epoch + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    writePosition.store (hostPosition, std::memory_order_relaxed);
+    sourceEpoch.store (epoch + 2, std::memory_order_release);
+
+    if (source != nullptr && producerRate > 0.0)
+    {
+        const auto filePosition = static_cast<juce::int64> (std::floor (static_cast<double> (hostPosition)
+                                                                        * source->reader->sampleRate / producerRate));
+        source->readerSource.setNextReadPosition (filePosition);
+        source->resampler.flushBuffers();
+    }
+}
+
+void ReferenceTrack::fillChunk (juce::int64 hostPosition)
+{
+    auto& reader = *source->reader;
+
+    // Keep a window of the file mapped around the read position so resident
+    // memory stays bounded however long the reference is.
+    const auto next = juce::jmax<juce::int64> (0, source->readerSource.getNextReadPosition());
+    const auto lookahead = static_cast<juce::int64> (chunkSize * reader.sampleRate / producerRate) + 1024;
+    const auto needed = juce::Range<juce::int64> (next, next + lookahead).getIntersectionWith ({ 0, reader.lengthInSamples });
+
+    if (! needed.isEmpty() && ! reader.getMappedSection().contains (needed))
+    {
+        const auto windowFrames = juce::jmax (lookahead, static_cast<juce::int64> (mapWindowSeconds * reader.sampleRate));
+        reader.mapSectionOfFile ({ needed.getStart(), juce::jmin (reader.lengthInSamples, needed.getStart() + windowFrames) });
+    }
+
+    const juce::AudioSourceChannelInfo info (&chunkBuffer, 0, chunkSize);
+    source->resampler.getNextAudioBlock (info);
+
+    const int start = static_cast<int> (hostPosition & (ringSize - 1));
+    const int first = juce::jmin (chunkSize, ringSize - start);
+    const auto* left = chunkBuffer.getReadPointer (0);
+    const auto* right = chunkBuffer.getReadPointer (1);
+
+    std::copy_n (left, first, ringLeft.data() + start);
+    std::copy_n (right, first, ringRight.data() + start);
+    std::copy_n (left + first, chunkSize - first, ringLeft.data());
+    std::copy_n (right + first, chunkSize - first, ringRight.data());
+
+    writePosition.store (hostPosition + chunkSize, std::memory_order_release);
+}
+
+void ReferenceTrack::setPendingSource (std::unique_ptr<Source> newSource)
+{
+    lengthSeconds.store (newSource != nullptr ? newSource->getLengthSeconds() : 0.0);
+
+    const juce::ScopedLock sl (pendingLock);
+    pendingSource = std::move (newSource);
+    pendingChange = true;
+}
+
+std::unique_ptr<ReferenceTrack::Source> ReferenceTrack::openMapped (const juce::File& file, juce::AudioFormatManager& formats)
+{
+    auto* format = formats.findFormatForFileExtension (file.getFileExtension());
+
+    if (format == nullptr || ! file.existsAsFile())
+        return nullptr;
+
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader (format->createMemoryMappedReader (file));
+
+    if (reader == nullptr || reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    const auto initialFrames = static_cast<juce::int64> (mapWindowSeconds * reader->sampleRate);
+
+    if (! reader->mapSectionOfFile ({ 0, juce::jmin (reader->lengthInSamples, initialFrames) }))
+        return nullptr;
+
+    return std::make_unique<Source> (reader.release());
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedTimeSliceThread.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// A reference file streamed in step with the host transport. WAV and AIFF are
+// memory-mapped a section at a time; other formats are decoded once to a
+// float WAV in the cache folder and mapped from there. A shared background
+// thread resamples to the host rate and keeps a ring of read-ahead frames
+// filled; the audio thread only ever copies out of that ring.
+class ReferenceTrack : private juce::TimeSliceClient
+{
+public:
+    enum class Status
+    {
+        empty,
+        decoding,
+        ready,
+        failed
+    };
+
+    ReferenceTrack();
+    ~ReferenceTrack() override;
+
+    // Message thread.
+    void load (const juce::File& file);
+    void clear();
+    juce::File getFile() const;
+    Status getStatus() const noexcept          { return status.load(); }
+    double getLengthSeconds() const noexcept   { return lengthSeconds.load(); }
+    size_t getMemoryBytes() const noexcept     { return ringReady.load() ? 2 * (size_t) ringSize * sizeof (float) : 0; }
+
+    // Called from prepareToPlay; the producer picks the new rate up on its next pass.
+    void prepare (double hostSampleRate) noexcept;
+
+    // Audio thread. Copies host-rate frames [position, position + numSamples)
+    // and returns true, or clears both channels and returns false if they are
+    // not buffered yet. A jump in position starts a seek; it never waits.
+    bool read (juce::int64 position, float* left, float* right, int numSamples) noexcept;
+
+private:
+    struct Source;
+    class DecodeThread;
+
+    // Keeps every instance's read-ahead filled. It is not the processor's
+    // preparer thread: after a seek the read-ahead is empty, and a chain build
+    // queued ahead of the refill would leave the first blocks silent.
+    struct StreamerThread
+    {
+        static constexpr const char* name = "NeonScope Reference";
+    };
+
+    static constexpr int ringSize = 1 << 16;
+    static constexpr int chunkSize = 2048;
+
+    int useTimeSlice() override;
+    void adoptPendingSource();
+    void restartAt (juce::int64 hostPosition);
+    void fillChunk (juce::int64 hostPosition);
+    void setPendingSource (std::unique_ptr<Source> newSource);
+    static std::unique_ptr<Source> openMapped (const juce::File& file, juce::AudioFormatManager& formats);
+
+    juce::SharedResourcePointer<SharedTimeSliceThread<StreamerThread>> streamer;
+    juce::AudioFormatManager formats;
+
+    // Message thread only.
+    juce::File file;
+    std::unique_ptr<DecodeThread> decoder;
+
+    // Handed from the message or decode thread to the producer.
+    juce::CriticalSection pendingLock;
+    std::unique_ptr<Source> pendingSource;
+    bool pendingChange = false;
+
+    // Producer only.
+    std::unique_ptr<Source> source;
+    juce::AudioBuffer<float> chunkBuffer;
+    juce::uint32 handledGeneration = 0;
+    double producerRate = 0.0;
+
+    // Allocated by the first load(), then kept until destruction so the
+    // audio thread never sees it move.
+    std::vector<float> ringLeft, ringRight;
+    std::atomic<bool> ringReady { false };
+
+    // Positions are absolute host-rate frames; slot = position & (ringSize - 1).
+    std::atomic<juce::int64> writePosition { 0 };
+    std::atomic<juce::int64> readPosition { 0 };
+    std::atomic<juce::int64> seekTarget { 0 };
+    std::atomic<juce::uint32> seekGeneration { 0 };
+    std::atomic<juce::uint32> acknowledgedGeneration { 0 };
+    std::atomic<double> hostRate { 44100.0 };
+
+    // Bumped to odd before the producer rewinds writePosition and to even
+    // after, so a read that overlapped a restart can be discarded.
+    std::atomic<juce::uint32> sourceEpoch { 0 };
+
+    // Audio thread only.
+    juce::int64 expectedPosition = -1;
+    juce::uint32 requestedGeneration = 0;
+
+    std::atomic<Status> status { Status::empty };
+    std::atomic<double> lengthSeconds { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE (ReferenceTrack)
+};
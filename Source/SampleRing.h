@@ -0,0 +1,119 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+// Single-writer, single-reader ring of stereo samples, from the audio thread
+// to a display that wants every sample rather than a summary. The writer
+// never waits: a block that doesn't fit is dropped and counted, which is also
+// what happens while nothing is reading.
+//
+// After a drop the writer keeps dropping until the reader has emptied the
+// ring, so the queued samples never have a gap inside them. It then publishes
+// where it resumes, and the reader takes its position from that.
+class SampleRing
+{
+public:
+    explicit SampleRing (int capacity)
+        : fifo (capacity), left ((size_t) capacity), right ((size_t) capacity) {}
+
+    // Writer side. right may be null for a mono input. Blocks are kept whole,
+    // so numSamples must not exceed the capacity.
+    void push (const float* leftSamples, const float* rightSamples, int numSamples) noexcept
+    {
+        jassert (numSamples < fifo.getTotalSize());
+
+        const auto position = pushed;
+        pushed += (juce::uint64) numSamples;
+
+        if (dropping)
+        {
+            if (fifo.getNumReady() > 0)
+            {
+                dropped.fetch_add ((juce::uint32) numSamples, std::memory_order_relaxed);
+                return;
+            }
+
+            // Stored before the samples are written, so a reader that sees
+            // them sees this too.
+            dropping = false;
+            resumePosition.store (position, std::memory_order_relaxed);
+            resumes.fetch_add (1, std::memory_order_release);
+        }
+
+        if (fifo.getFreeSpace() < numSamples)
+        {
+            dropping = true;
+            dropped.fetch_add ((juce::uint32) numSamples, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto scope = fifo.write (numSamples);
+        copy (leftSamples, rightSamples, 0, scope.startIndex1, scope.blockSize1);
+        copy (leftSamples, rightSamples, scope.blockSize1, scope.startIndex2, scope.blockSize2);
+    }
+
+    // Reader side: calls onBlock (uint64 position, const float* left, const
+    // float* right, int numSamples) for everything queued, oldest first, in at
+    // most two blocks, and returns the number of samples. position counts
+    // every sample pushed since construction, dropped ones included, so it
+    // lines up with sample counts kept by the writer.
+    template <typename Callback>
+    int read (Callback&& onBlock)
+    {
+        int numRead = 0;
+
+        {
+            const auto scope = fifo.read (fifo.getNumReady());
+
+            // The writer only resumes into an empty ring, so a resume seen
+            // here lies before everything in this scope and after everything
+            // read before.
+            if (const auto resumesNow = resumes.load (std::memory_order_acquire); resumesNow != resumesSeen)
+            {
+                resumesSeen = resumesNow;
+                readPosition = resumePosition.load (std::memory_order_relaxed);
+            }
+
+            if (scope.blockSize1 > 0)
+                onBlock (readPosition, left.data() + scope.startIndex1, right.data() + scope.startIndex1, scope.blockSize1);
+
+            if (scope.blockSize2 > 0)
+                onBlock (readPosition + (juce::uint64) scope.blockSize1, left.data() + scope.startIndex2, right.data() + scope.startIndex2, scope.blockSize2);
+
+            numRead = scope.blockSize1 + scope.blockSize2;
+        }
+
+        readPosition += (juce::uint64) numRead;
+        return numRead;
+    }
+
+    int getCapacity() const noexcept                { return fifo.getTotalSize(); }
+    size_t getMemoryBytes() const noexcept          { return (left.size() + right.size()) * sizeof (float); }
+    juce::uint32 getDroppedCount() const noexcept   { return dropped.load (std::memory_order_relaxed); }
+
+private:
+    void copy (const float* leftSamples, const float* rightSamples, int from, int to, int count) noexcept
+    {
+        if (count <= 0)
+            return;
+
+        juce::FloatVectorOperations::copy (left.data() + to, leftSamples + from, count);
+        juce::FloatVectorOperations::copy (right.data() + to, (rightSamples != nullptr ? rightSamples : leftSamples) + from, count);
+    }
+
+    juce::AbstractFifo fifo;
+    std::vector<float> left, right;
+    std::atomic<juce::uint32> dropped { 0 };
+    std::atomic<juce::uint64> resumePosition { 0 };
+    std::atomic<juce::uint32> resumes { 0 };
+
+    // Writer only.
+    juce::uint64 pushed = 0;
+    bool dropping = false;
+
+    // Reader only.
+    juce::uint64 readPosition = 0;
+    juce::uint32 resumesSeen = 0;
+};
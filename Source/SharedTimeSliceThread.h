@@ -0,0 +1,16 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// A juce::TimeSliceThread shared by every instance in the process, held
+// through juce::SharedResourcePointer: started with the first instance that
+// uses it and stopped with the last. Each Tag type gets its own thread,
+// named by Tag::name.
+template <typename Tag>
+struct SharedTimeSliceThread
+{
+    SharedTimeSliceThread() { thread.startThread(); }
+    ~SharedTimeSliceThread() { thread.stopThread (2000); }
+
+    juce::TimeSliceThread thread { Tag::name };
+};
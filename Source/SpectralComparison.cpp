@@ -0,0 +1,59 @@
+#include "SpectralComparison.h"
+#include "TraceRecorder.h"
+
+namespace
+{
+    // Band energy, after the 1 / fftSize scaling, below which a signal counts
+    // as silent in that band: about -100 dB.
+    constexpr double silentEnergy = 1.0e-10;
+}
+
+void SpectralComparison::prepare (double sampleRate)
+{
+    frames.prepare();
+
+    for (int band = 0; band < numBands; ++band)
+        bandBins[(size_t) band] = AnalysisEngine::getBandBins (band, sampleRate);
+
+    reset();
+}
+
+void SpectralComparison::reset() noexcept
+{
+    frames.reset();
+    result = {};
+}
+
+// Only the bins inside a band are split; the rest of the spectrum is not
+// needed here.
+const SpectralComparison::Result& SpectralComparison::compute() noexcept
+{
+    NEONSCOPE_TRACE_SCOPE ("Sidechain bands");
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const auto bins = bandBins[(size_t) band];
+        double mainEnergy = 0.0, keyEnergy = 0.0, maskedEnergy = 0.0;
+        float keyMagnitudes = 0.0f;
+
+        for (int bin = bins.getStart(); bin < bins.getEnd(); ++bin)
+        {
+            const float mainPower = std::norm (frames.first (bin));
+            const float keyPower = std::norm (frames.second (bin));
+
+            mainEnergy += mainPower;
+            keyEnergy += keyPower;
+            maskedEnergy += keyPower >= mainPower ? mainPower : 0.0f;
+            keyMagnitudes += std::sqrt (keyPower);
+        }
+
+        result.keyLevels[(size_t) band] = AnalysisEngine::toDisplayLevel (bins.isEmpty() ? 0.0f : keyMagnitudes / (float) bins.getLength());
+
+        const bool silent = mainEnergy + keyEnergy < silentEnergy;
+        const auto differenceDb = 10.0 * std::log10 ((mainEnergy + silentEnergy) / (keyEnergy + silentEnergy));
+        result.differenceDb[(size_t) band] = silent ? 0.0f : juce::jlimit (-maxDifferenceDb, maxDifferenceDb, (float) differenceDb);
+        result.masking[(size_t) band] = silent ? 0.0f : (float) (maskedEnergy / juce::jmax (mainEnergy, silentEnergy));
+    }
+
+    return result;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisEngine.h"
+#include "PairedFft.h"
+#include <array>
+
+// Compares the spectrum of the main signal with a key signal on the sidechain,
+// for example a bass against the kick it should make room for, on the same
+// bands as the level display.
+//
+// Both mono mixes go through one PairedFft, main first and key second, framed,
+// windowed and scaled exactly as AnalysisEngine's. Each frame gives, per band:
+//
+//  - keyLevels: the key's level, normalised like AnalysisEngine's bands
+//  - differenceDb: main minus key energy, within +/-maxDifferenceDb
+//  - masking: the share of the main signal's energy in bins where the key is
+//    at least as loud, from 0 (clear) to 1 (covered)
+//
+// Bands where both are silent read 0.
+class SpectralComparison
+{
+public:
+    using Bands = AnalysisEngine::Bands;
+
+    static constexpr float maxDifferenceDb = 24.0f;
+
+    struct Result
+    {
+        Bands keyLevels {}, differenceDb {}, masking {};
+    };
+
+    // Allocates on the first call only; later calls just recompute the band
+    // bin ranges and reset.
+    void prepare (double sampleRate);
+    void reset() noexcept;
+    bool isPrepared() const noexcept  { return frames.isPrepared(); }
+
+    // Feeds both signals into the FIFOs and calls onFrame (const Result&)
+    // each time they fill. Either right channel may be null for mono input.
+    template <typename FrameCallback>
+    void push (const float* mainLeft, const float* mainRight, const float* keyLeft, const float* keyRight,
+               int numSamples, FrameCallback&& onFrame)
+    {
+        frames.push (mainLeft, mainRight, keyLeft, keyRight, numSamples, [this, &onFrame] { onFrame (compute()); });
+    }
+
+    size_t getMemoryBytes() const noexcept  { return frames.getMemoryBytes(); }
+
+private:
+    static constexpr int numBands = AnalysisEngine::numBands;
+
+    const Result& compute() noexcept;
+
+    PairedFft frames;
+    std::array<juce::Range<int>, numBands> bandBins {};
+    Result result;
+};
@@ -0,0 +1,178 @@
+#include "SpectrumCurve.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr double minFrequency = 20.0;
+    constexpr double maxFrequency = 20000.0;
+
+    // How far a column falls towards a lower reading per frame; rises are immediate.
+    constexpr float release = 0.3f;
+}
+
+void SpectrumCurve::setArea (juce::Rectangle<float> newArea)
+{
+    if (newArea == area)
+        return;
+
+    area = newArea;
+    layoutValid = false;
+}
+
+void SpectrumCurve::setSmoothing (Smoothing newSmoothing)
+{
+    if (newSmoothing == smoothing)
+        return;
+
+    smoothing = newSmoothing;
+    layoutValid = false;
+}
+
+void SpectrumCurve::rebuildLayout (double sampleRate)
+{
+    constexpr int numBins = AnalysisEngine::numBins;
+    const int numColumns = juce::jmax (0, juce::roundToInt (area.getWidth()));
+    const double binsPerHz = AnalysisEngine::fftSize / sampleRate;
+    const double ratio = maxFrequency / minFrequency;
+
+    columnBins.resize ((size_t) numColumns);
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const double lowHz = minFrequency * std::pow (ratio, (double) column / numColumns);
+        const double highHz = minFrequency * std::pow (ratio, (double) (column + 1) / numColumns);
+        const int first = juce::jmin (numBins, (int) std::ceil (lowHz * binsPerHz));
+        const int last = juce::jmin (numBins, (int) std::ceil (highHz * binsPerHz));
+
+        auto& bins = columnBins[(size_t) column];
+
+        if (last > first)
+        {
+            bins = { first, last - first, 0.0f };
+        }
+        else
+        {
+            const double centre = std::sqrt (lowHz * highHz) * binsPerHz;
+            const int below = juce::jlimit (0, numBins - 2, (int) centre);
+            bins = { below, 0, juce::jlimit (0.0f, 1.0f, (float) (centre - below)) };
+        }
+    }
+
+    levels.assign ((size_t) numColumns, 0.0f);
+    points.resize ((size_t) numColumns);
+
+    // Three floats per lineTo, plus the corners and close of the fill.
+    outline.preallocateSpace (3 * numColumns + 3);
+    fill.preallocateSpace (3 * numColumns + 12);
+
+    if (smoothing != Smoothing::off)
+    {
+        const double octaves = smoothing == Smoothing::twelfthOctave ? 1.0 / 12.0
+                             : smoothing == Smoothing::sixthOctave   ? 1.0 / 6.0
+                                                                     : 1.0 / 3.0;
+        const double halfWidth = std::pow (2.0, octaves * 0.5);
+
+        windowLow.resize ((size_t) numBins);
+        windowHigh.resize ((size_t) numBins);
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            windowLow[(size_t) bin] = juce::jmin (bin, juce::roundToInt (bin / halfWidth));
+            windowHigh[(size_t) bin] = juce::jlimit (bin, numBins - 1, juce::roundToInt (bin * halfWidth));
+        }
+
+        powerSums.resize ((size_t) numBins + 1);
+        smoothed.resize ((size_t) numBins);
+    }
+
+    layoutSampleRate = sampleRate;
+    layoutValid = true;
+}
+
+const float* SpectrumCurve::smooth (const float* magnitudes) noexcept
+{
+    constexpr int numBins = AnalysisEngine::numBins;
+
+    // Running power sum, so any window's mean is one subtraction. Doubles keep
+    // quiet bins next to loud ones well above the rounding error.
+    powerSums[0] = 0.0;
+    for (int bin = 0; bin < numBins; ++bin)
+        powerSums[(size_t) bin + 1] = powerSums[(size_t) bin] + (double) magnitudes[bin] * magnitudes[bin];
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const int low = windowLow[(size_t) bin];
+        const int high = windowHigh[(size_t) bin];
+        const double power = (powerSums[(size_t) high + 1] - powerSums[(size_t) low]) / (high - low + 1);
+        smoothed[(size_t) bin] = (float) std::sqrt (juce::jmax (0.0, power));
+    }
+
+    return smoothed.data();
+}
+
+bool SpectrumCurve::update (const AnalysisEngine::Spectrum& spectrum)
+{
+    bool moved = ! layoutValid || spectrum.sampleRate != layoutSampleRate;
+
+    if (moved)
+        rebuildLayout (spectrum.sampleRate);
+
+    if (columnBins.empty())
+    {
+        outline.clear();
+        fill.clear();
+        return moved;
+    }
+
+    const auto* source = smoothing == Smoothing::off ? spectrum.magnitudes.data() : smooth (spectrum.magnitudes.data());
+
+    for (size_t column = 0; column < columnBins.size(); ++column)
+    {
+        const auto& bins = columnBins[column];
+        float magnitude;
+
+        if (bins.count > 0)
+        {
+            magnitude = source[bins.first];
+            for (int bin = bins.first + 1; bin < bins.first + bins.count; ++bin)
+                magnitude = juce::jmax (magnitude, source[bin]);
+        }
+        else
+        {
+            magnitude = source[bins.first] + bins.fraction * (source[bins.first + 1] - source[bins.first]);
+        }
+
+        const float dbValue = juce::Decibels::gainToDecibels (magnitude, -120.0f);
+        const float target = juce::jlimit (0.0f, 1.0f, juce::jmap (dbValue, AnalysisEngine::spectrumFloorDb,
+                                                                   AnalysisEngine::spectrumCeilingDb, 0.0f, 1.0f));
+        auto& level = levels[column];
+        level = target >= level ? target : level + (target - level) * release;
+
+        // Against the drawn point, so slow drifts still show once they add up.
+        moved = moved || std::abs (levelToY (level) - points[column].y) >= 0.5f;
+    }
+
+    if (! moved)
+        return false;
+
+    for (size_t column = 0; column < points.size(); ++column)
+        points[column] = { area.getX() + (float) column + 0.5f, levelToY (levels[column]) };
+
+    outline.clear();
+    fill.clear();
+
+    outline.startNewSubPath (points.front());
+    fill.startNewSubPath (area.getBottomLeft());
+    fill.lineTo (points.front());
+
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+        outline.lineTo (points[i]);
+        fill.lineTo (points[i]);
+    }
+
+    fill.lineTo (area.getBottomRight());
+    fill.closeSubPath();
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisEngine.h"
+#include <vector>
+
+// The full-resolution spectrum as a curve with one point per pixel column,
+// log-spaced from 20 Hz to 20 kHz. Which bins feed which column is worked out
+// once per layout (width, sample rate, smoothing): a column spanning several
+// bins takes their maximum, one narrower than a bin interpolates between its
+// neighbours. Each update is then O(bins + columns), and the paths it builds
+// have one vertex per column, so drawing cost follows the editor width and
+// not the FFT size.
+//
+// Optional fractional-octave smoothing averages power over a window that
+// grows with frequency. Both window edges only move forward as the centre
+// bin rises, so the averages come from one running sum over the bins.
+class SpectrumCurve
+{
+public:
+    // Ids match the smoothing combo box items.
+    enum class Smoothing
+    {
+        off = 1,
+        twelfthOctave,
+        sixthOctave,
+        thirdOctave
+    };
+
+    // Message thread. Rebuilds the bin mapping only if something changed.
+    void setArea (juce::Rectangle<float> area);
+    void setSmoothing (Smoothing);
+    Smoothing getSmoothing() const noexcept  { return smoothing; }
+
+    // Maps a new frame onto the columns and rebuilds both paths. Returns
+    // false if no point moved by half a pixel or more.
+    bool update (const AnalysisEngine::Spectrum& spectrum);
+
+    const juce::Path& getOutline() const noexcept  { return outline; }
+    const juce::Path& getFill() const noexcept     { return fill; }
+
+private:
+    // Bins [first, first + count) for a column, or for count == 0 the point
+    // fraction of the way from bin first to bin first + 1.
+    struct ColumnBins
+    {
+        int first = 0, count = 0;
+        float fraction = 0.0f;
+    };
+
+    void rebuildLayout (double sampleRate);
+    const float* smooth (const float* magnitudes) noexcept;
+    float levelToY (float level) const noexcept  { return area.getBottom() - area.getHeight() * level; }
+
+    juce::Rectangle<float> area;
+    Smoothing smoothing = Smoothing::off;
+    double layoutSampleRate = 0.0;
+    bool layoutValid = false;
+
+    std::vector<ColumnBins> columnBins;
+    std::vector<float> levels;                 // 0..1 per column, with release
+    std::vector<juce::Point<float>> points;   // as last drawn
+
+    // Smoothing window edges per bin, inclusive, and the workspace for it.
+    std::vector<int> windowLow, windowHigh;
+    std::vector<double> powerSums;
+    std::vector<float> smoothed;
+
+    juce::Path outline, fill;
+};
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef NEONSCOPE_PROFILING
+ #define NEONSCOPE_PROFILING 0
+#endif
+
+#if NEONSCOPE_PROFILING
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+// Per-stage timing for processBlock. Stage scopes add their time into plain
+// per-block counters; endBlock() then writes one sample per stage into
+// histograms that only the audio thread writes and the editor reads lock-free.
+class StageProfiler
+{
+public:
+    enum Stage
+    {
+        filter,
+        saturation,
+        oversampling,
+        width,
+        gain,
+        limiter,
+        metering,
+        loudness,
+        truePeak,
+        fft,
+        total,
+        numStages
+    };
+
+    using Ticks = juce::uint64;
+
+    static constexpr int numBuckets = 128;
+
+    struct StageStats
+    {
+        juce::uint64 blocks = 0;
+        double meanMicroseconds = 0.0;
+        double p99Microseconds = 0.0;
+        double maxMicroseconds = 0.0;
+        double budgetPercent = 0.0;
+    };
+
+    // Reader-side copy of the counters; collect() reports what happened
+    // since the snapshot it was last given.
+    struct Snapshot
+    {
+        std::array<std::array<juce::uint32, numBuckets>, numStages> counts {};
+        std::array<Ticks, numStages> ticks {};
+        juce::uint64 samples = 0;
+    };
+
+    class ScopedStage
+    {
+    public:
+        ScopedStage (StageProfiler& p, Stage s) noexcept : profiler (p), stage (s), start (now()) {}
+        ~ScopedStage() noexcept { profiler.blockTicks[(size_t) stage] += now() - start; }
+
+    private:
+        StageProfiler& profiler;
+        const Stage stage;
+        const Ticks start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedStage)
+    };
+
+    static const char* getStageName (int stage) noexcept
+    {
+        static constexpr const char* names[] { "Filter", "Saturation", "Oversampling", "Width",
+                                               "Gain & mix", "Limiter", "Metering", "Loudness",
+                                               "True peak", "FFT", "Total" };
+        return juce::isPositiveAndBelow (stage, (int) numStages) ? names[stage] : "";
+    }
+
+    // rdtsc where available: a steady_clock read costs about as much as the
+    // smaller stages themselves.
+    static Ticks now() noexcept
+    {
+       #if JUCE_INTEL
+        return static_cast<Ticks> (__rdtsc());
+       #else
+        return static_cast<Ticks> (std::chrono::duration_cast<std::chrono::nanoseconds> (
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+       #endif
+    }
+
+    // Calibrated once per process, the first time stats are collected.
+    static double ticksPerMicrosecond()
+    {
+       #if JUCE_INTEL
+        static const double rate = []
+        {
+            const auto wallStart = std::chrono::steady_clock::now();
+            const auto tickStart = now();
+            std::this_thread::sleep_for (std::chrono::milliseconds (20));
+            const auto elapsedTicks = static_cast<double> (now() - tickStart);
+            const auto elapsedMicroseconds = std::chrono::duration<double, std::micro> (std::chrono::steady_clock::now() - wallStart).count();
+            return elapsedMicroseconds > 0.0 ? elapsedTicks / elapsedMicroseconds : 1000.0;
+        }();
+        return rate;
+       #else
+        return 1000.0;
+       #endif
+    }
+
+    void setSampleRate (double newSampleRate) noexcept  { sampleRate.store (newSampleRate); }
+
+    void beginBlock() noexcept
+    {
+        blockTicks.fill (0);
+
+        if (maxResetRequested.exchange (false, std::memory_order_acquire))
+            for (auto& m : maxTicks)
+                m.store (0, std::memory_order_relaxed);
+    }
+
+    void endBlock (int numSamples, Ticks totalTicks) noexcept
+    {
+        blockTicks[(size_t) total] = totalTicks;
+
+        for (size_t stage = 0; stage < (size_t) numStages; ++stage)
+        {
+            const auto ticks = blockTicks[stage];
+
+            if (ticks == 0)
+                continue;
+
+            auto& bucket = counts[stage][(size_t) bucketFor (ticks)];
+            bucket.store (bucket.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            tickSums[stage].store (tickSums[stage].load (std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+
+            if (ticks > maxTicks[stage].load (std::memory_order_relaxed))
+                maxTicks[stage].store (ticks, std::memory_order_relaxed);
+        }
+
+        samplesProcessed.store (samplesProcessed.load (std::memory_order_relaxed) + (juce::uint64) numSamples,
+                                std::memory_order_release);
+    }
+
+    std::array<StageStats, numStages> collect (Snapshot& previous)
+    {
+        std::array<StageStats, numStages> stats;
+        const double tpu = ticksPerMicrosecond();
+
+        const auto samples = samplesProcessed.load (std::memory_order_acquire);
+        const auto newSamples = samples - previous.samples;
+        previous.samples = samples;
+
+        const double rate = sampleRate.load();
+        const double budgetMicroseconds = rate > 0.0 ? 1.0e6 * static_cast<double> (newSamples) / rate : 0.0;
+
+        for (size_t stage = 0; stage < (size_t) numStages; ++stage)
+        {
+            std::array<juce::uint32, numBuckets> delta {};
+            juce::uint64 blocks = 0;
+
+            for (size_t b = 0; b < (size_t) numBuckets; ++b)
+            {
+                const auto count = counts[stage][b].load (std::memory_order_relaxed);
+                delta[b] = count - previous.counts[stage][b];
+                previous.counts[stage][b] = count;
+                blocks += delta[b];
+            }
+
+            const auto ticks = tickSums[stage].load (std::memory_order_relaxed);
+            const auto newTicks = ticks - previous.ticks[stage];
+            previous.ticks[stage] = ticks;
+
+            auto& s = stats[stage];
+            s.blocks = blocks;
+            s.maxMicroseconds = static_cast<double> (maxTicks[stage].load (std::memory_order_relaxed)) / tpu;
+
+            if (blocks == 0)
+                continue;
+
+            s.meanMicroseconds = static_cast<double> (newTicks) / static_cast<double> (blocks) / tpu;
+            s.budgetPercent = budgetMicroseconds > 0.0 ? 100.0 * static_cast<double> (newTicks) / tpu / budgetMicroseconds : 0.0;
+
+            const auto p99Rank = static_cast<juce::uint64> (std::ceil (0.99 * static_cast<double> (blocks)));
+            juce::uint64 cumulative = 0;
+
+            for (int b = 0; b < numBuckets; ++b)
+            {
+                cumulative += delta[(size_t) b];
+
+                if (cumulative >= p99Rank)
+                {
+                    s.p99Microseconds = static_cast<double> (bucketUpperEdge (b)) / tpu;
+                    break;
+                }
+            }
+        }
+
+        maxResetRequested.store (true, std::memory_order_release);
+        return stats;
+    }
+
+private:
+    // Four buckets per octave of ticks, which keeps p99 within about 20%.
+    static int bucketFor (Ticks ticks) noexcept
+    {
+        const auto clamped = static_cast<juce::uint32> (juce::jmin<Ticks> (ticks, 0xffffffffu));
+
+        if (clamped < 4)
+            return static_cast<int> (clamped);
+
+        const int msb = juce::findHighestSetBit (clamped);
+        return msb * 4 + static_cast<int> ((clamped >> (msb - 2)) & 3u);
+    }
+
+    static Ticks bucketUpperEdge (int bucket) noexcept
+    {
+        if (bucket < 8)
+            return static_cast<Ticks> (bucket + 1);
+
+        return static_cast<Ticks> (5 + bucket % 4) << (bucket / 4 - 2);
+    }
+
+    std::array<Ticks, numStages> blockTicks {};
+    std::array<std::array<std::atomic<juce::uint32>, numBuckets>, numStages> counts {};
+    std::array<std::atomic<Ticks>, numStages> tickSums {};
+    std::array<std::atomic<Ticks>, numStages> maxTicks {};
+    std::atomic<juce::uint64> samplesProcessed { 0 };
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<bool> maxResetRequested { false };
+};
+
+ #define NEONSCOPE_PROFILE_STAGE(profiler, stage) \
+    const StageProfiler::ScopedStage JUCE_JOIN_MACRO (profiledStage_, __LINE__) (profiler, StageProfiler::stage)
+
+#else
+
+ #define NEONSCOPE_PROFILE_STAGE(profiler, stage)
+
+#endif
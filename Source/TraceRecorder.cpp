@@ -0,0 +1,259 @@
+#include "TraceRecorder.h"
+
+#include <array>
+#include <chrono>
+#include <memory>
+
+std::atomic<bool> TraceRecorder::enabled { false };
+
+namespace
+{
+    constexpr int maxThreads = 32;
+    constexpr juce::uint32 ringSize = 8192;
+    constexpr int flushIntervalMs = 100;
+
+    struct TraceEvent
+    {
+        const char* name;
+        juce::int64 start;
+        juce::int64 end;
+    };
+
+    // Written only by the thread that claimed it, read only by the flusher.
+    struct ThreadRing
+    {
+        std::array<TraceEvent, ringSize> events;
+        std::atomic<juce::uint32> writeIndex { 0 };
+        std::atomic<juce::uint32> readIndex { 0 };
+        std::atomic<juce::uint32> dropped { 0 };
+        std::atomic<bool> claimed { false };
+        bool isMessageThread = false;
+        bool named = false;
+    };
+
+    class Flusher : public juce::Thread
+    {
+    public:
+        Flusher() : juce::Thread ("NeonScope Trace") {}
+
+        std::unique_ptr<juce::FileOutputStream> stream;
+        juce::int64 originNanos = 0;
+        bool firstEvent = true;
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                wait (flushIntervalMs);
+                drain();
+            }
+
+            drain();
+        }
+
+        void drain();
+
+    private:
+        void writeEvent (const juce::String& json)
+        {
+            *stream << (firstEvent ? "\n" : ",\n") << json;
+            firstEvent = false;
+        }
+    };
+
+    // Rings are allocated on the first start() and never freed, so a thread's
+    // cached pointer stays valid across stop/start cycles.
+    struct TraceState
+    {
+        juce::CriticalSection lock;
+        std::unique_ptr<std::array<ThreadRing, maxThreads>> rings;
+        std::atomic<int> claimedRings { 0 };
+        Flusher flusher;
+        bool environmentChecked = false;
+
+        ~TraceState()  { finish(); }
+
+        // Caller holds lock, or is the destructor.
+        void finish()
+        {
+            if (! flusher.isThreadRunning())
+                return;
+
+            flusher.signalThreadShouldExit();
+            flusher.notify();
+            flusher.stopThread (2000);
+
+            *flusher.stream << "\n]}\n";
+            flusher.stream.reset();
+        }
+    };
+
+    TraceState& getState()
+    {
+        static TraceState state;
+        return state;
+    }
+
+    ThreadRing* getThreadRing() noexcept
+    {
+        thread_local ThreadRing* ring = nullptr;
+        thread_local bool exhausted = false;
+
+        if (ring != nullptr || exhausted)
+            return ring;
+
+        auto& state = getState();
+        const int index = state.claimedRings.fetch_add (1, std::memory_order_relaxed);
+
+        if (index >= maxThreads)
+        {
+            exhausted = true;
+            return nullptr;
+        }
+
+        ring = &(*state.rings)[(size_t) index];
+        ring->isMessageThread = juce::MessageManager::existsAndIsCurrentThread();
+        ring->claimed.store (true, std::memory_order_release);
+        return ring;
+    }
+
+    void Flusher::drain()
+    {
+        auto& state = getState();
+        const int numRings = juce::jmin (state.claimedRings.load (std::memory_order_relaxed), maxThreads);
+
+        for (int index = 0; index < numRings; ++index)
+        {
+            auto& ring = (*state.rings)[(size_t) index];
+
+            if (! ring.claimed.load (std::memory_order_acquire))
+                continue;
+
+            const int tid = index + 1;
+
+            if (! ring.named)
+            {
+                const auto threadName = ring.isMessageThread ? juce::String ("Message thread")
+                                                             : "Thread " + juce::String (tid);
+                writeEvent ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + juce::String (tid)
+                            + ",\"args\":{\"name\":\"" + threadName + "\"}}");
+                ring.named = true;
+            }
+
+            const auto readIndex = ring.readIndex.load (std::memory_order_relaxed);
+            const auto writeIndex = ring.writeIndex.load (std::memory_order_acquire);
+
+            for (auto i = readIndex; i != writeIndex; ++i)
+            {
+                const auto& event = ring.events[i & (ringSize - 1)];
+                const double startMicros = static_cast<double> (event.start - originNanos) * 1.0e-3;
+                const double durationMicros = static_cast<double> (event.end - event.start) * 1.0e-3;
+
+                writeEvent ("{\"name\":\"" + juce::String (event.name) + "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                            + juce::String (tid) + ",\"ts\":" + juce::String (startMicros, 3)
+                            + ",\"dur\":" + juce::String (durationMicros, 3) + "}");
+            }
+
+            ring.readIndex.store (writeIndex, std::memory_order_release);
+
+            if (const auto dropped = ring.dropped.exchange (0, std::memory_order_relaxed))
+                writeEvent ("{\"name\":\"dropped\",\"ph\":\"C\",\"pid\":1,\"tid\":" + juce::String (tid)
+                            + ",\"ts\":" + juce::String (static_cast<double> (TraceRecorder::now() - originNanos) * 1.0e-3, 3)
+                            + ",\"args\":{\"events\":" + juce::String (dropped) + "}}");
+        }
+
+        stream->flush();
+    }
+}
+
+juce::int64 TraceRecorder::now() noexcept
+{
+    return static_cast<juce::int64> (std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void TraceRecorder::record (const char* name, juce::int64 startNanos, juce::int64 endNanos) noexcept
+{
+    auto* ring = getThreadRing();
+
+    if (ring == nullptr)
+        return;
+
+    const auto writeIndex = ring->writeIndex.load (std::memory_order_relaxed);
+
+    if (writeIndex - ring->readIndex.load (std::memory_order_acquire) >= ringSize)
+    {
+        ring->dropped.fetch_add (1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring->events[writeIndex & (ringSize - 1)] = { name, startNanos, endNanos };
+    ring->writeIndex.store (writeIndex + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::start (const juce::File& destination)
+{
+    auto& state = getState();
+    const juce::ScopedLock sl (state.lock);
+
+    if (state.flusher.isThreadRunning())
+        return false;
+
+    auto stream = std::make_unique<juce::FileOutputStream> (destination);
+
+    if (! stream->openedOk())
+        return false;
+
+    stream->setPosition (0);
+    stream->truncate();
+    *stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    if (state.rings == nullptr)
+        state.rings = std::make_unique<std::array<ThreadRing, maxThreads>>();
+
+    // Skip anything written after the previous stop().
+    for (auto& ring : *state.rings)
+    {
+        ring.readIndex.store (ring.writeIndex.load (std::memory_order_acquire), std::memory_order_release);
+        ring.named = false;
+    }
+
+    state.flusher.stream = std::move (stream);
+    state.flusher.originNanos = now();
+    state.flusher.firstEvent = true;
+    state.flusher.startThread();
+
+    enabled.store (true);
+    return true;
+}
+
+void TraceRecorder::stop()
+{
+    auto& state = getState();
+    const juce::ScopedLock sl (state.lock);
+
+    if (! state.flusher.isThreadRunning())
+        return;
+
+    enabled.store (false);
+    state.finish();
+}
+
+void TraceRecorder::startFromEnvironment()
+{
+    auto& state = getState();
+
+    {
+        const juce::ScopedLock sl (state.lock);
+
+        if (state.environmentChecked)
+            return;
+
+        state.environmentChecked = true;
+    }
+
+    const auto path = juce::SystemStats::getEnvironmentVariable ("NEONSCOPE_TRACE", {});
+
+    if (path.isNotEmpty() && juce::File::isAbsolutePath (path))
+        start (juce::File (path));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Process-wide Chrome/Perfetto trace capture. Each thread that records gets
+// its own single-producer ring; a background thread drains the rings and
+// appends "X" events to a JSON file that chrome://tracing or ui.perfetto.dev
+// can open. While tracing is off a scope costs one relaxed load and branch.
+//
+// Start it from code, or set NEONSCOPE_TRACE=/path/to/trace.json before the
+// host loads the plug-in.
+class TraceRecorder
+{
+public:
+    static bool isEnabled() noexcept  { return enabled.load (std::memory_order_relaxed); }
+
+    // Nanoseconds on a monotonic clock.
+    static juce::int64 now() noexcept;
+
+    // Names must be string literals: only the pointer is stored.
+    static void record (const char* name, juce::int64 startNanos, juce::int64 endNanos) noexcept;
+
+    static bool start (const juce::File& destination);
+    static void stop();
+    static void startFromEnvironment();
+
+    class Scope
+    {
+    public:
+        explicit Scope (const char* scopeName) noexcept
+            : name (scopeName), start (isEnabled() ? now() : 0) {}
+
+        ~Scope() noexcept
+        {
+            if (start != 0)
+                record (name, start, now());
+        }
+
+    private:
+        const char* const name;
+        const juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+#define NEONSCOPE_TRACE_SCOPE(name) \
+    const TraceRecorder::Scope JUCE_JOIN_MACRO (traceScope_, __LINE__) (name)
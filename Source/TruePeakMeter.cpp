@@ -0,0 +1,148 @@
+#include "TruePeakMeter.h"
+
+#include <algorithm>
+#include <cmath>
+
+TruePeakMeter::TruePeakMeter()
+{
+    // Kaiser-windowed sinc with its cutoff at the original Nyquist frequency.
+    // Each phase is normalised to unity DC gain so a constant reads as itself.
+    constexpr int numTaps = numPhases * tapsPerPhase;
+    std::array<float, numTaps> window {};
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) numTaps,
+                                                              juce::dsp::WindowingFunction<float>::kaiser, false, 6.0f);
+
+    std::array<std::array<float, tapsPerPhase>, numPhases> phases {};
+    constexpr double centre = (numTaps - 1) * 0.5;
+
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        const double x = (tap - centre) / numPhases;
+        const double sinc = std::sin (juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+        phases[(size_t) (tap % numPhases)][(size_t) (tap / numPhases)] = static_cast<float> (sinc * window[(size_t) tap]);
+    }
+
+    maxPhaseGain = 0.0f;
+
+    for (auto& phase : phases)
+    {
+        float sum = 0.0f;
+        for (auto value : phase)
+            sum += value;
+
+        float absoluteSum = 0.0f;
+        for (auto& value : phase)
+        {
+            value /= sum;
+            absoluteSum += std::abs (value);
+        }
+
+        maxPhaseGain = juce::jmax (maxPhaseGain, absoluteSum);
+    }
+
+    for (int k = 0; k < tapsPerPhase; ++k)
+    {
+        auto coefficient = Vec::expand (0.0f);
+
+        for (int phase = 0; phase < numPhases; ++phase)
+            coefficient.set ((size_t) phase, phases[(size_t) phase][(size_t) k]);
+
+        coefficients[(size_t) k] = coefficient;
+    }
+
+    overThreshold = juce::Decibels::decibelsToGain (overThresholdDb);
+
+    for (auto& line : lines)
+        line.assign ((size_t) (historySize + maxChunk), 0.0f);
+}
+
+void TruePeakMeter::reset() noexcept
+{
+    for (auto& line : lines)
+        std::fill (line.begin(), line.end(), 0.0f);
+
+    periodPeaks.fill (0.0f);
+    aboveThreshold.fill (false);
+    hold = 0.0f;
+    overCount = 0;
+}
+
+void TruePeakMeter::process (const float* left, const float* right, int numSamples) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* samples = channel == 0 ? left : right;
+
+        if (samples == nullptr)
+            continue;
+
+        float peak = 0.0f;
+
+        for (int offset = 0; offset < numSamples; offset += maxChunk)
+            peak = juce::jmax (peak, processChannel (channel, samples + offset, juce::jmin (maxChunk, numSamples - offset)));
+
+        periodPeaks[(size_t) channel] = juce::jmax (periodPeaks[(size_t) channel], peak);
+        hold = juce::jmax (hold, peak);
+
+        const bool above = peak > overThreshold;
+        overCount += above && ! aboveThreshold[(size_t) channel] ? 1 : 0;
+        aboveThreshold[(size_t) channel] = above;
+    }
+}
+
+float TruePeakMeter::processChannel (int channel, const float* samples, int numSamples) noexcept
+{
+    auto* line = lines[(size_t) channel].data();
+    std::copy_n (samples, numSamples, line + historySize);
+
+    // The true peak is never below the sample peak, which is a cheap first bound.
+    const auto sampleRange = juce::FloatVectorOperations::findMinAndMax (samples, numSamples);
+    float peak = juce::jmax (-sampleRange.getStart(), sampleRange.getEnd());
+
+    for (int start = 0; start < numSamples; start += groupSize)
+    {
+        const int count = juce::jmin (groupSize, numSamples - start);
+
+        // Outputs start..start+count-1 read line[start .. start+count+historySize).
+        const auto inputRange = juce::FloatVectorOperations::findMinAndMax (line + start, count + historySize);
+        const float inputPeak = juce::jmax (-inputRange.getStart(), inputRange.getEnd());
+
+        if (inputPeak * maxPhaseGain > peak)
+            peak = juce::jmax (peak, interpolateMax (line + start, count));
+    }
+
+    // NaN fails every comparison above; keep it out of the history too.
+    if (! std::isfinite (peak))
+    {
+        std::fill_n (line, historySize + numSamples, 0.0f);
+        return 0.0f;
+    }
+
+    std::copy_n (line + numSamples, historySize, line);
+    return peak;
+}
+
+float TruePeakMeter::interpolateMax (const float* line, int numOutputs) const noexcept
+{
+    const auto zero = Vec::expand (0.0f);
+    auto largest = zero;
+
+    for (int n = 0; n < numOutputs; ++n)
+    {
+        // y_p[n] = sum_k h_p[k] x[n - k], with x[n] at line[n + historySize].
+        const auto* newest = line + n + historySize;
+        auto frame = zero;
+
+        for (int k = 0; k < tapsPerPhase; ++k)
+            frame = Vec::multiplyAdd (frame, coefficients[(size_t) k], Vec::expand (newest[-k]));
+
+        largest = Vec::max (largest, Vec::max (frame, zero - frame));
+    }
+
+    float peak = 0.0f;
+
+    for (size_t phase = 0; phase < Vec::SIMDNumElements; ++phase)
+        peak = juce::jmax (peak, largest.get (phase));
+
+    return peak;
+}
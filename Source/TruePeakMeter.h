@@ -0,0 +1,62 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// BS.1770-4 Annex 2 style true-peak detection: a 48-tap, 4-phase polyphase
+// interpolator evaluated one output frame (all four phases) per SIMD
+// register. Nothing is upsampled into a buffer. A run of input is only
+// interpolated if its largest sample, times the largest phase gain, could
+// beat the peak already found, so quiet passages cost a min/max scan.
+class TruePeakMeter
+{
+public:
+    static constexpr int numChannels = 2;
+
+    TruePeakMeter();
+
+    void reset() noexcept;
+
+    // right may be null for mono input.
+    void process (const float* left, const float* right, int numSamples) noexcept;
+
+    // Largest linear true peak per channel since the last resetPeriod().
+    float getPeriodPeak (int channel) const noexcept  { return periodPeaks[(size_t) channel]; }
+    void resetPeriod() noexcept                        { periodPeaks.fill (0.0f); }
+
+    // Since reset(): the largest true peak on either channel, and how many
+    // times a channel has gone above overThreshold after being below it.
+    float getHold() const noexcept      { return hold; }
+    int getOverCount() const noexcept   { return overCount; }
+
+    size_t getMemoryBytes() const noexcept  { return numChannels * (historySize + maxChunk) * sizeof (float); }
+
+    static constexpr float overThresholdDb = -1.0f;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int numPhases = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int historySize = tapsPerPhase - 1;
+    static constexpr int maxChunk = 512;
+    static constexpr int groupSize = 16;
+
+    static_assert (Vec::SIMDNumElements == numPhases, "one output frame per register");
+
+    float processChannel (int channel, const float* samples, int numSamples) noexcept;
+    float interpolateMax (const float* line, int numOutputs) const noexcept;
+
+    // coefficients[k] holds tap k of every phase.
+    std::array<Vec, tapsPerPhase> coefficients;
+    float maxPhaseGain = 1.0f;
+    float overThreshold = 1.0f;
+
+    // Per channel: the last historySize samples, then room for one chunk.
+    std::array<std::vector<float>, numChannels> lines;
+    std::array<float, numChannels> periodPeaks {};
+    std::array<bool, numChannels> aboveThreshold {};
+    float hold = 0.0f;
+    int overCount = 0;
+};
@@ -0,0 +1,276 @@
+#include <JuceHeader.h>
+#include "AnalysisEngine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Runs audio files through the plug-in's metering and spectrum engine as fast
+// as they decode, one file per worker, and writes one row per analysis window.
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct AnalyzeOptions
+    {
+        double windowSeconds = 0.1;
+        bool json = false;
+        juce::File outputDirectory;
+    };
+
+    // WAV and AIFF are mapped straight from disk; anything else goes through
+    // the regular streaming reader.
+    std::unique_ptr<juce::AudioFormatReader> createReader (juce::AudioFormatManager& formats, const juce::File& file)
+    {
+        if (auto* format = formats.findFormatForFileExtension (file.getFileExtension()))
+        {
+            if (std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped { format->createMemoryMappedReader (file) })
+                if (mapped->mapEntireFile())
+                    return mapped;
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader> (formats.createReaderFor (file));
+    }
+
+    juce::StringArray getColumnNames()
+    {
+        juce::StringArray columns { "time", "peakLeftDb", "peakRightDb", "rmsLeftDb", "rmsRightDb", "correlation", "width" };
+
+        for (int band = 0; band < AnalysisEngine::numBands; ++band)
+            columns.add ("band" + juce::String (band));
+
+        return columns;
+    }
+
+    class AnalyzeJob : public juce::ThreadPoolJob
+    {
+    public:
+        AnalyzeJob (const juce::File& source, const AnalyzeOptions& analyzeOptions)
+            : juce::ThreadPoolJob (source.getFileName()), file (source), options (analyzeOptions) {}
+
+        double audioSeconds = 0.0;
+        double elapsedSeconds = 0.0;
+        bool succeeded = false;
+
+        JobStatus runJob() override
+        {
+            const auto start = Clock::now();
+            succeeded = analyze();
+            elapsedSeconds = std::chrono::duration<double> (Clock::now() - start).count();
+
+            if (succeeded)
+                std::printf ("%s: %.1f s of audio in %.3f s (%.0fx real time)\n", file.getFullPathName().toRawUTF8(),
+                             audioSeconds, elapsedSeconds, elapsedSeconds > 0.0 ? audioSeconds / elapsedSeconds : 0.0);
+
+            return jobHasFinished;
+        }
+
+    private:
+        bool analyze()
+        {
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+
+            const auto reader = createReader (formats, file);
+
+            if (reader == nullptr || reader->sampleRate <= 0.0)
+            {
+                std::fprintf (stderr, "%s: unsupported or unreadable file\n", file.getFullPathName().toRawUTF8());
+                return false;
+            }
+
+            const auto outputFile = (options.outputDirectory == juce::File() ? file.getParentDirectory() : options.outputDirectory)
+                                        .getChildFile (file.getFileNameWithoutExtension() + (options.json ? ".analysis.json" : ".analysis.csv"));
+            outputFile.deleteFile();
+            juce::FileOutputStream output (outputFile);
+
+            if (! output.openedOk())
+            {
+                std::fprintf (stderr, "%s: cannot write %s\n", file.getFullPathName().toRawUTF8(),
+                              outputFile.getFullPathName().toRawUTF8());
+                return false;
+            }
+
+            const double sampleRate = reader->sampleRate;
+            const int numChannels = juce::jmin (2, static_cast<int> (reader->numChannels));
+            const auto windowSamples = juce::jmax<juce::int64> (1, juce::roundToInt (options.windowSeconds * sampleRate));
+            constexpr int chunkSize = 4096;
+
+            AnalysisEngine engine;
+            engine.prepare (sampleRate);
+
+            juce::AudioBuffer<float> buffer (numChannels, chunkSize);
+            AnalysisEngine::Bands bandSums {};
+            AnalysisEngine::Bands lastBands {};
+            int framesInWindow = 0;
+
+            writeHeader (output, sampleRate);
+
+            juce::int64 position = 0;
+            bool firstRow = true;
+
+            while (position < reader->lengthInSamples)
+            {
+                const auto windowEnd = juce::jmin (reader->lengthInSamples, position + windowSamples);
+                const auto windowStart = position;
+
+                while (position < windowEnd)
+                {
+                    const int count = static_cast<int> (juce::jmin<juce::int64> (chunkSize, windowEnd - position));
+                    reader->read (&buffer, 0, count, position, true, numChannels > 1);
+
+                    const auto* left = buffer.getReadPointer (0);
+                    const auto* right = numChannels > 1 ? buffer.getReadPointer (1) : nullptr;
+
+                    engine.accumulateMeters (left, right, count);
+                    engine.pushSpectrum (left, right, count, [&] (const AnalysisEngine::Bands& bands)
+                    {
+                        for (size_t band = 0; band < bands.size(); ++band)
+                            bandSums[band] += bands[band];
+
+                        ++framesInWindow;
+                    });
+
+                    position += count;
+                }
+
+                // Windows shorter than an FFT frame repeat the last spectrum.
+                if (framesInWindow > 0)
+                    for (size_t band = 0; band < lastBands.size(); ++band)
+                        lastBands[band] = bandSums[band] / static_cast<float> (framesInWindow);
+
+                writeRow (output, static_cast<double> (windowStart) / sampleRate, engine.getMeters(), lastBands, firstRow);
+
+                engine.resetMeters();
+                bandSums.fill (0.0f);
+                framesInWindow = 0;
+                firstRow = false;
+            }
+
+            if (options.json)
+                output << "\n]}\n";
+
+            audioSeconds = static_cast<double> (reader->lengthInSamples) / sampleRate;
+            return true;
+        }
+
+        void writeHeader (juce::OutputStream& output, double sampleRate) const
+        {
+            if (! options.json)
+            {
+                output << getColumnNames().joinIntoString (",") << "\n";
+                return;
+            }
+
+            output << "{\"file\":" << juce::JSON::toString (file.getFullPathName())
+                   << ",\"sampleRate\":" << sampleRate
+                   << ",\"windowSeconds\":" << options.windowSeconds
+                   << ",\"columns\":" << juce::JSON::toString (juce::var (getColumnNames()), true)
+                   << ",\"windows\":[";
+        }
+
+        void writeRow (juce::OutputStream& output, double time, const AnalysisEngine::MeterAccumulator& meters,
+                       const AnalysisEngine::Bands& bands, bool firstRow) const
+        {
+            const auto toDb = [] (float gain) { return juce::String (juce::Decibels::gainToDecibels (gain, -120.0f), 2); };
+            constexpr auto separator = ",";
+
+            juce::String row;
+            row.preallocateBytes (256);
+            row << juce::String (time, 3)
+                << separator << toDb (meters.peakLeft) << separator << toDb (meters.peakRight)
+                << separator << toDb (meters.getRmsLeft()) << separator << toDb (meters.getRmsRight())
+                << separator << juce::String (meters.getCorrelation(), 3)
+                << separator << juce::String (meters.getWidth(), 3);
+
+            for (const auto level : bands)
+                row << separator << juce::String (level, 3);
+
+            if (options.json)
+                output << (firstRow ? "\n[" : ",\n[") << row << "]";
+            else
+                output << row << "\n";
+        }
+
+        const juce::File file;
+        const AnalyzeOptions options;
+    };
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList args (argc, argv);
+
+    const juce::StringArray valueOptions { "--window-ms", "--format", "--out", "--jobs" };
+    juce::Array<juce::File> files;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& argument = args[i];
+
+        if (argument.isOption())
+        {
+            if (valueOptions.contains (argument.text) && i + 1 < args.size())
+                ++i;
+
+            continue;
+        }
+
+        files.add (argument.resolveAsFile());
+    }
+
+    if (files.isEmpty())
+    {
+        std::fprintf (stderr, "usage: neonscope-analyze [--window-ms 100] [--format csv|json] [--out dir] [--jobs N] files...\n");
+        return 2;
+    }
+
+    const auto stringOption = [&args] (const char* option, const juce::String& defaultValue)
+    {
+        return args.containsOption (option) ? args.getValueForOption (option) : defaultValue;
+    };
+
+    AnalyzeOptions options;
+    options.windowSeconds = juce::jlimit (0.001, 60.0, stringOption ("--window-ms", "100").getDoubleValue() / 1000.0);
+    options.json = stringOption ("--format", "csv").equalsIgnoreCase ("json");
+
+    if (args.containsOption ("--out"))
+    {
+        options.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--out"));
+        options.outputDirectory.createDirectory();
+    }
+
+    const int numJobs = juce::jlimit (1, 256, stringOption ("--jobs", juce::String (juce::SystemStats::getNumCpus())).getIntValue());
+
+    std::vector<std::unique_ptr<AnalyzeJob>> jobs;
+    juce::ThreadPool pool (numJobs);
+
+    const auto start = Clock::now();
+
+    for (const auto& file : files)
+    {
+        jobs.push_back (std::make_unique<AnalyzeJob> (file, options));
+        pool.addJob (jobs.back().get(), false);
+    }
+
+    for (auto& job : jobs)
+        pool.waitForJobToFinish (job.get(), -1);
+
+    const double elapsedSeconds = std::chrono::duration<double> (Clock::now() - start).count();
+    double audioSeconds = 0.0;
+    int failures = 0;
+
+    for (const auto& job : jobs)
+    {
+        audioSeconds += job->audioSeconds;
+        failures += job->succeeded ? 0 : 1;
+    }
+
+    const double realTime = elapsedSeconds > 0.0 ? audioSeconds / elapsedSeconds : 0.0;
+    std::printf ("%d file(s), %.1f s of audio in %.3f s on %d job(s): %.0fx real time, %.0fx per job\n",
+                 files.size() - failures, audioSeconds, elapsedSeconds, numJobs, realTime, realTime / numJobs);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,911 @@
+#include <JuceHeader.h>
+#include "BandFilterbank.h"
+#include "PluginEditor.h"
+#include "PluginProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <vector>
+
+#if ! NEONSCOPE_PROFILING
+ #error "NeonScopeBench reads per-stage times from StageProfiler; build it with NEONSCOPE_PROFILING=1"
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince (Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli> (Clock::now() - start).count();
+    }
+
+    void setParameter (NeonScopeAudioProcessor& processor, const juce::String& paramID, float value)
+    {
+        if (auto* parameter = processor.getValueTreeState().getParameter (paramID))
+            parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    void prepare (NeonScopeAudioProcessor& processor, double sampleRate, int blockSize)
+    {
+        processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+    }
+
+    void report (const char* phase, double totalMs, int numInstances)
+    {
+        std::printf ("  %-26s %10.3f ms total %10.3f us/instance\n",
+                     phase, totalMs, 1000.0 * totalMs / juce::jmax (1, numInstances));
+    }
+
+    // Session load: instantiate and prepare every instance, then the
+    // re-prepare calls hosts make on transport restarts, rate probes and
+    // buffer-size changes.
+    void runStartupBenchmark (int numInstances, int mode, double sampleRate, int blockSize)
+    {
+        std::printf ("startup: %d instances, mode %d, %.0f Hz, %d samples\n",
+                     numInstances, mode, sampleRate, blockSize);
+
+        std::vector<std::unique_ptr<NeonScopeAudioProcessor>> instances;
+        instances.reserve (static_cast<size_t> (numInstances));
+
+        auto start = Clock::now();
+        for (int i = 0; i < numInstances; ++i)
+        {
+            instances.push_back (std::make_unique<NeonScopeAudioProcessor>());
+            setParameter (*instances.back(), "mode", static_cast<float> (mode));
+        }
+        const double instantiateMs = millisecondsSince (start);
+
+        start = Clock::now();
+        for (auto& processor : instances)
+            prepare (*processor, sampleRate, blockSize);
+        const double prepareMs = millisecondsSince (start);
+
+        start = Clock::now();
+        for (auto& processor : instances)
+            prepare (*processor, sampleRate, blockSize);
+        const double reprepareMs = millisecondsSince (start);
+
+        start = Clock::now();
+        for (auto& processor : instances)
+        {
+            processor->releaseResources();
+            prepare (*processor, sampleRate, blockSize);
+        }
+        const double releaseReprepareMs = millisecondsSince (start);
+
+        start = Clock::now();
+        for (auto& processor : instances)
+            prepare (*processor, sampleRate, blockSize * 2);
+        const double resizedMs = millisecondsSince (start);
+
+        report ("instantiate", instantiateMs, numInstances);
+        report ("first prepare", prepareMs, numInstances);
+        report ("instantiate + prepare", instantiateMs + prepareMs, numInstances);
+        report ("re-prepare (unchanged)", reprepareMs, numInstances);
+        report ("release + re-prepare", releaseReprepareMs, numInstances);
+        report ("re-prepare (new block)", resizedMs, numInstances);
+
+        const auto footprint = instances.front()->getMemoryFootprint();
+        std::printf ("  memory per instance: %zu bytes (level history %zu)\n", footprint.total(), footprint.history);
+    }
+
+    // ─── Stage benchmarks ───────────────────────────────────────────────────
+
+    // One processor configuration and the profiler stage it isolates. Each
+    // case runs the real processBlock; StageProfiler attributes the time.
+    struct StageCase
+    {
+        juce::String name;
+        StageProfiler::Stage stage;
+        std::vector<std::pair<juce::String, float>> parameters;
+        bool stereoOnly = false;
+    };
+
+    struct StageResult
+    {
+        juce::String name;
+        juce::String stage;
+        int blockSize = 0;
+        int channels = 0;
+        double nsPerSample = 0.0;
+        double xRealTime = 0.0;
+        double p99Microseconds = 0.0;
+
+        juce::String key() const  { return name + "@" + juce::String (blockSize) + "x" + juce::String (channels); }
+    };
+
+    std::vector<StageCase> createStageCases()
+    {
+        std::vector<StageCase> cases;
+
+        const juce::StringArray saturators { "tanh", "soft", "tube", "arctan", "hard clip", "foldback" };
+        for (int i = 0; i < saturators.size(); ++i)
+            cases.push_back ({ "saturator/" + saturators[i], StageProfiler::saturation,
+                               { { "mode", 2.0f }, { "oversampling", 0.0f }, { "satMode", (float) i } } });
+
+        // 1x has no oversampling stage to time.
+        const juce::StringArray factors { "1x", "1.3x", "1.7x", "2x", "4x" };
+        for (int i = 1; i < factors.size(); ++i)
+            cases.push_back ({ "oversampling/" + factors[i], StageProfiler::oversampling,
+                               { { "mode", 2.0f }, { "oversampling", (float) i }, { "satMode", 0.0f } } });
+
+        const juce::StringArray filters { "lowpass", "highpass", "bandpass" };
+        for (int i = 0; i < filters.size(); ++i)
+            cases.push_back ({ "filter/" + filters[i], StageProfiler::filter,
+                               { { "mode", 1.0f }, { "filterType", (float) i } } });
+
+        cases.push_back ({ "width", StageProfiler::width, { { "mode", 1.0f }, { "width", 1.5f } }, true });
+        cases.push_back ({ "limiter", StageProfiler::limiter, { { "mode", 2.0f }, { "SAFETY_LIMITER", 1.0f } } });
+        cases.push_back ({ "metering", StageProfiler::metering, { { "mode", 0.0f } } });
+        cases.push_back ({ "loudness", StageProfiler::loudness, { { "mode", 0.0f } } });
+        cases.push_back ({ "true peak", StageProfiler::truePeak, { { "mode", 0.0f } } });
+        cases.push_back ({ "fft band mapping", StageProfiler::fft, { { "mode", 0.0f } } });
+        cases.push_back ({ "fft + filterbank", StageProfiler::fft, { { "mode", 0.0f }, { "bandAnalysis", 1.0f } } });
+
+        for (int mode = 0; mode < 4; ++mode)
+            cases.push_back ({ "total/mode " + juce::String (mode), StageProfiler::total,
+                               { { "mode", (float) mode }, { "oversampling", mode >= 2 ? 3.0f : 0.0f } } });
+
+        return cases;
+    }
+
+    // Fails if the processor won't take the layout or the stage never ran.
+    bool runStageCase (const StageCase& stageCase, int blockSize, int channels, double sampleRate,
+                       double seconds, StageResult& result)
+    {
+        NeonScopeAudioProcessor processor;
+
+        for (const auto& [paramID, value] : stageCase.parameters)
+            setParameter (processor, paramID, value);
+
+        const auto channelSet = channels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+        // Only the main buses change; the sidechain stays as the processor
+        // declares it, disabled.
+        auto layout = processor.getBusesLayout();
+        layout.inputBuses.getReference (0) = channelSet;
+        layout.outputBuses.getReference (0) = channelSet;
+
+        if (! processor.setBusesLayout (layout))
+            return false;
+
+        prepare (processor, sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer (channels, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random (0x5eed);
+
+        const auto runFor = [&] (double durationSeconds)
+        {
+            const auto numBlocks = juce::jmax (1, static_cast<int> (durationSeconds * sampleRate / blockSize));
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int ch = 0; ch < channels; ++ch)
+                {
+                    auto* data = buffer.getWritePointer (ch);
+                    for (int i = 0; i < blockSize; ++i)
+                        data[i] = (random.nextFloat() * 2.0f - 1.0f) * 0.5f;
+                }
+
+                processor.processBlock (buffer, midi);
+            }
+        };
+
+        auto& profiler = processor.getProfiler();
+        StageProfiler::Snapshot snapshot;
+
+        // Warm caches and let the first meter and FFT frames settle.
+        runFor (0.25);
+        profiler.collect (snapshot);
+
+        runFor (seconds);
+        const auto stats = profiler.collect (snapshot)[(size_t) stageCase.stage];
+
+        if (stats.blocks == 0)
+            return false;
+
+        result.name = stageCase.name;
+        result.stage = StageProfiler::getStageName (stageCase.stage);
+        result.blockSize = blockSize;
+        result.channels = channels;
+        result.nsPerSample = 1000.0 * stats.meanMicroseconds / blockSize;
+        result.xRealTime = stats.budgetPercent > 0.0 ? 100.0 / stats.budgetPercent : 0.0;
+        result.p99Microseconds = stats.p99Microseconds;
+        return true;
+    }
+
+    // Cases that could not run are counted in failures rather than skipped,
+    // so a baseline comparison never passes on an empty table.
+    std::vector<StageResult> runStageBenchmarks (const juce::Array<int>& blockSizes, const juce::Array<int>& channelCounts,
+                                                 double sampleRate, double seconds, int& failures)
+    {
+        std::printf ("stages: %.0f Hz, %.1f s of audio per case\n", sampleRate, seconds);
+        std::printf ("  %-24s %6s %3s %12s %14s %10s\n", "case", "block", "ch", "ns/sample", "x real-time", "p99 us");
+
+        std::vector<StageResult> results;
+
+        for (const auto& stageCase : createStageCases())
+        {
+            for (const auto channels : channelCounts)
+            {
+                if (stageCase.stereoOnly && channels != 2)
+                    continue;
+
+                for (const auto blockSize : blockSizes)
+                {
+                    StageResult result;
+
+                    if (! runStageCase (stageCase, blockSize, channels, sampleRate, seconds, result))
+                    {
+                        std::printf ("  %-24s %6d %3d %12s\n", stageCase.name.toRawUTF8(), blockSize, channels, "FAIL");
+                        ++failures;
+                        continue;
+                    }
+
+                    std::printf ("  %-24s %6d %3d %12.3f %14.1f %10.2f\n", result.name.toRawUTF8(), blockSize, channels,
+                                 result.nsPerSample, result.xRealTime, result.p99Microseconds);
+                    results.push_back (result);
+                }
+            }
+        }
+
+        return results;
+    }
+
+    juce::var resultsToJson (const std::vector<StageResult>& results, double sampleRate)
+    {
+        juce::Array<juce::var> entries;
+
+        for (const auto& result : results)
+        {
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty ("name", result.name);
+            entry->setProperty ("stage", result.stage);
+            entry->setProperty ("blockSize", result.blockSize);
+            entry->setProperty ("channels", result.channels);
+            entry->setProperty ("nsPerSample", result.nsPerSample);
+            entry->setProperty ("xRealTime", result.xRealTime);
+            entry->setProperty ("p99Microseconds", result.p99Microseconds);
+            entries.add (juce::var (entry));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty ("sampleRate", sampleRate);
+        root->setProperty ("juceVersion", juce::SystemStats::getJUCEVersion());
+        root->setProperty ("results", entries);
+        return juce::var (root);
+    }
+
+    // Returns the number of cases slower than the baseline by more than
+    // thresholdPercent.
+    int compareWithBaseline (const std::vector<StageResult>& results, const juce::var& baseline, double thresholdPercent)
+    {
+        std::map<juce::String, double> baselineNs;
+
+        if (auto* entries = baseline["results"].getArray())
+        {
+            for (const auto& entry : *entries)
+            {
+                StageResult stored;
+                stored.name = entry["name"].toString();
+                stored.blockSize = entry["blockSize"];
+                stored.channels = entry["channels"];
+                baselineNs[stored.key()] = entry["nsPerSample"];
+            }
+        }
+
+        std::printf ("baseline comparison (threshold %.1f%%):\n", thresholdPercent);
+        int regressions = 0;
+
+        for (const auto& result : results)
+        {
+            const auto found = baselineNs.find (result.key());
+
+            if (found == baselineNs.end() || found->second <= 0.0)
+            {
+                std::printf ("  %-36s no baseline\n", result.key().toRawUTF8());
+                continue;
+            }
+
+            const double changePercent = 100.0 * (result.nsPerSample - found->second) / found->second;
+            const bool regressed = changePercent > thresholdPercent;
+            regressions += regressed ? 1 : 0;
+
+            std::printf ("  %-36s %10.3f -> %10.3f ns/sample %+7.1f%%%s\n", result.key().toRawUTF8(),
+                         found->second, result.nsPerSample, changePercent, regressed ? "  REGRESSION" : "");
+        }
+
+        std::printf ("%d regression(s)\n", regressions);
+        return regressions;
+    }
+
+    // ─── Loudness conformance ───────────────────────────────────────────────
+
+    // The EBU Tech 3341 and 3342 minimum-requirement cases, synthesised as the
+    // documents specify them: 1 kHz stereo sines at the given dBFS levels.
+    struct LoudnessCase
+    {
+        const char* name;
+        std::vector<std::pair<float, double>> segments;   // level dBFS, seconds
+        bool checksRange;
+        float expected;
+        float tolerance;
+    };
+
+    LoudnessMeter::Results measureLoudness (const LoudnessCase& loudnessCase, double sampleRate)
+    {
+        LoudnessMeter meter;
+        meter.prepare (sampleRate);
+
+        constexpr int blockSize = 512;
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        const double phaseIncrement = juce::MathConstants<double>::twoPi * 1000.0 / sampleRate;
+        double phase = 0.0;
+
+        for (const auto& [levelDb, seconds] : loudnessCase.segments)
+        {
+            const auto amplitude = juce::Decibels::decibelsToGain (levelDb, -200.0f);
+            auto remaining = static_cast<juce::int64> (seconds * sampleRate);
+
+            while (remaining > 0)
+            {
+                const int count = static_cast<int> (juce::jmin<juce::int64> (blockSize, remaining));
+
+                for (int i = 0; i < count; ++i)
+                {
+                    const auto value = amplitude * static_cast<float> (std::sin (phase));
+                    buffer.setSample (0, i, value);
+                    buffer.setSample (1, i, value);
+                    phase = std::fmod (phase + phaseIncrement, juce::MathConstants<double>::twoPi);
+                }
+
+                meter.process (buffer.getReadPointer (0), buffer.getReadPointer (1), count);
+                remaining -= count;
+            }
+        }
+
+        return meter.getResults();
+    }
+
+    // Returns the number of failed cases.
+    int runLoudnessConformance (double sampleRate, double seconds)
+    {
+        const std::vector<LoudnessCase> cases {
+            { "3341 case 1", { { -23.0f, 20.0 } }, false, -23.0f, 0.1f },
+            { "3341 case 2", { { -33.0f, 20.0 } }, false, -33.0f, 0.1f },
+            { "3341 case 3", { { -36.0f, 10.0 }, { -23.0f, 60.0 }, { -36.0f, 10.0 } }, false, -23.0f, 0.1f },
+            { "3341 case 4", { { -72.0f, 10.0 }, { -36.0f, 10.0 }, { -23.0f, 60.0 }, { -36.0f, 10.0 }, { -72.0f, 10.0 } }, false, -23.0f, 0.1f },
+            { "3341 case 5", { { -26.0f, 20.0 }, { -20.0f, 20.1 }, { -26.0f, 20.0 } }, false, -23.0f, 0.1f },
+            { "3342 case 1", { { -20.0f, 20.0 }, { -30.0f, 20.0 } }, true, 10.0f, 1.0f },
+            { "3342 case 2", { { -20.0f, 20.0 }, { -15.0f, 20.0 } }, true, 5.0f, 1.0f },
+            { "3342 case 3", { { -40.0f, 20.0 }, { -20.0f, 20.0 } }, true, 20.0f, 1.0f },
+            { "3342 case 4", { { -50.0f, 20.0 }, { -35.0f, 20.0 }, { -20.0f, 20.0 }, { -35.0f, 20.0 }, { -50.0f, 20.0 } }, true, 15.0f, 1.0f }
+        };
+
+        std::printf ("loudness: %.0f Hz\n", sampleRate);
+        std::printf ("  %-12s %10s %10s %10s\n", "case", "expected", "measured", "");
+
+        int failures = 0;
+
+        for (const auto& loudnessCase : cases)
+        {
+            const auto results = measureLoudness (loudnessCase, sampleRate);
+            const auto measured = loudnessCase.checksRange ? results.range : results.integrated;
+            const bool passed = std::abs (measured - loudnessCase.expected) <= loudnessCase.tolerance;
+            failures += passed ? 0 : 1;
+
+            std::printf ("  %-12s %7.1f %-2s %10.2f %10s\n", loudnessCase.name, loudnessCase.expected,
+                         loudnessCase.checksRange ? "LU" : "LUFS", measured, passed ? "ok" : "FAIL");
+        }
+
+        // Cost of the meter alone, on stereo noise.
+        LoudnessMeter meter;
+        meter.prepare (sampleRate);
+
+        constexpr int blockSize = 512;
+        juce::AudioBuffer<float> noise (2, blockSize);
+        juce::Random random (0x5eed);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                noise.setSample (ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+        const auto numBlocks = juce::jmax (1, static_cast<int> (seconds * sampleRate / blockSize));
+        const auto start = Clock::now();
+
+        for (int block = 0; block < numBlocks; ++block)
+            meter.process (noise.getReadPointer (0), noise.getReadPointer (1), blockSize);
+
+        const double nsPerSample = 1.0e6 * millisecondsSince (start) / ((double) numBlocks * blockSize);
+        std::printf ("  meter cost: %.3f ns per stereo sample\n", nsPerSample);
+        std::printf ("%d failure(s)\n", failures);
+        return failures;
+    }
+
+    // ─── True peak ──────────────────────────────────────────────────────────
+
+    // Full-scale sines whose samples miss the crest: an fs/4 sine at 45 degrees
+    // only ever samples at -3 dBFS but peaks at 0 dBTP.
+    struct TruePeakCase
+    {
+        const char* name;
+        double cyclesPerSample;
+        double phase;
+    };
+
+    // Returns the number of failed cases.
+    int runTruePeakChecks (double sampleRate, double seconds)
+    {
+        const TruePeakCase cases[] {
+            { "fs/4, 45 deg", 0.25, juce::MathConstants<double>::pi / 4.0 },
+            { "fs/4, 0 deg", 0.25, 0.0 },
+            { "fs/6, 0 deg", 1.0 / 6.0, 0.0 },
+            { "997 Hz", 997.0 / sampleRate, 0.3 }
+        };
+
+        std::printf ("true peak: %.0f Hz\n", sampleRate);
+        std::printf ("  %-14s %10s %10s %10s\n", "case", "sample dB", "dBTP", "");
+
+        constexpr int blockSize = 512;
+        constexpr int warmUpBlocks = 4;
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        int failures = 0;
+
+        for (const auto& truePeakCase : cases)
+        {
+            TruePeakMeter meter;
+            float samplePeak = 0.0f;
+
+            for (int block = 0; block < warmUpBlocks + 16; ++block)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto n = static_cast<double> (block * blockSize + i);
+                    const auto value = static_cast<float> (std::sin (juce::MathConstants<double>::twoPi * truePeakCase.cyclesPerSample * n
+                                                                     + truePeakCase.phase));
+                    buffer.setSample (0, i, value);
+                    buffer.setSample (1, i, -value);
+                    samplePeak = juce::jmax (samplePeak, std::abs (value));
+                }
+
+                // The first blocks carry the ringing of the sine switching on.
+                if (block == warmUpBlocks)
+                    meter.resetPeriod();
+
+                meter.process (buffer.getReadPointer (0), buffer.getReadPointer (1), blockSize);
+            }
+
+            const auto truePeakDb = juce::Decibels::gainToDecibels (juce::jmax (meter.getPeriodPeak (0), meter.getPeriodPeak (1)));
+            const bool passed = truePeakDb > -0.4f && truePeakDb < 0.2f;
+            failures += passed ? 0 : 1;
+
+            std::printf ("  %-14s %10.2f %10.2f %10s\n", truePeakCase.name,
+                         juce::Decibels::gainToDecibels (samplePeak), truePeakDb, passed ? "ok" : "FAIL");
+        }
+
+        // Cost against the obvious alternative: 4x oversampling with JUCE's
+        // FIR oversampler, then a peak scan of the upsampled block.
+        juce::AudioBuffer<float> noise (2, blockSize);
+        juce::Random random (0x5eed);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                noise.setSample (ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+        const auto numBlocks = juce::jmax (1, static_cast<int> (seconds * sampleRate / blockSize));
+        const auto nsPerSample = [&] (Clock::time_point start)
+        {
+            return 1.0e6 * millisecondsSince (start) / ((double) numBlocks * blockSize);
+        };
+
+        TruePeakMeter meter;
+        auto start = Clock::now();
+
+        for (int block = 0; block < numBlocks; ++block)
+            meter.process (noise.getReadPointer (0), noise.getReadPointer (1), blockSize);
+
+        const double polyphaseNs = nsPerSample (start);
+
+        juce::dsp::Oversampling<float> oversampler (2, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true);
+        oversampler.initProcessing ((size_t) blockSize);
+        float oversampledPeak = 0.0f;
+        start = Clock::now();
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            juce::dsp::AudioBlock<float> input (noise);
+            auto upsampled = oversampler.processSamplesUp (input);
+
+            for (size_t ch = 0; ch < upsampled.getNumChannels(); ++ch)
+            {
+                const auto range = juce::FloatVectorOperations::findMinAndMax (upsampled.getChannelPointer (ch),
+                                                                               (int) upsampled.getNumSamples());
+                oversampledPeak = juce::jmax (oversampledPeak, -range.getStart(), range.getEnd());
+            }
+        }
+
+        const double oversamplingNs = nsPerSample (start);
+
+        std::printf ("  polyphase meter: %.3f ns per stereo sample (%.2f dBTP)\n", polyphaseNs,
+                     juce::Decibels::gainToDecibels (meter.getHold()));
+        std::printf ("  dsp::Oversampling 4x + scan: %.3f ns per stereo sample (%.2f dBTP)\n", oversamplingNs,
+                     juce::Decibels::gainToDecibels (oversampledPeak));
+        std::printf ("%d failure(s)\n", failures);
+        return failures;
+    }
+
+    // ─── Band analysis ──────────────────────────────────────────────────────
+
+    // Time for a band to come within 3 dB of its steady level after a sine at
+    // its centre starts, in samples, fed one sample at a time.
+    int filterbankResponseSamples (double sampleRate, int numBands)
+    {
+        const double frequency = 1000.0;
+        const int band = juce::jlimit (0, numBands - 1, (int) (std::log (frequency / 20.0) / std::log (1000.0) * numBands));
+        const auto toleranceNorm = 3.0f / (AnalysisEngine::spectrumCeilingDb - AnalysisEngine::spectrumFloorDb);
+        const int steadySamples = (int) sampleRate;
+
+        BandFilterbank filterbank;
+        filterbank.prepare (sampleRate, numBands);
+        std::vector<float> input ((size_t) steadySamples), levels ((size_t) numBands);
+
+        for (int i = 0; i < steadySamples; ++i)
+            input[(size_t) i] = 0.5f * (float) std::sin (juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+
+        filterbank.process (input.data(), nullptr, steadySamples);
+        filterbank.getLevels (levels.data());
+        const float steady = levels[(size_t) band];
+
+        filterbank.reset();
+
+        for (int i = 0; i < steadySamples; ++i)
+        {
+            filterbank.process (input.data() + i, nullptr, 1);
+            filterbank.getLevels (levels.data());
+
+            if (levels[(size_t) band] >= steady - toleranceNorm)
+                return i + 1;
+        }
+
+        return steadySamples;
+    }
+
+    // A steady sine at each band centre, through both analysis modes: the
+    // filterbank's levels are scaled to read as the FFT's, so switching modes
+    // must not move a tone. Bands too narrow to own an FFT bin read nothing in
+    // the FFT and are skipped.
+    int runBandLevelChecks (double sampleRate)
+    {
+        constexpr int numBands = AnalysisEngine::numBands;
+        constexpr float toleranceDb = 1.0f;
+        constexpr float amplitude = 0.5f;
+        const int numSamples = AnalysisEngine::fftSize * 8;
+        const auto displayRangeDb = AnalysisEngine::spectrumCeilingDb - AnalysisEngine::spectrumFloorDb;
+
+        std::printf ("band levels: %.0f Hz, sine of amplitude %.1f at each band centre\n", sampleRate, amplitude);
+        std::printf ("  %-6s %10s %10s %10s %10s\n", "band", "Hz", "FFT", "filterbank", "");
+
+        std::vector<float> input ((size_t) numSamples);
+        std::vector<float> filterbankLevels ((size_t) numBands);
+        int failures = 0;
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            const double centre = 20.0 * std::pow (1000.0, (band + 0.5) / numBands);
+
+            if (AnalysisEngine::getBandBins (band, sampleRate).isEmpty() || centre >= sampleRate * 0.45)
+                continue;
+
+            for (int i = 0; i < numSamples; ++i)
+                input[(size_t) i] = amplitude * (float) std::sin (juce::MathConstants<double>::twoPi * centre * i / sampleRate);
+
+            AnalysisEngine engine;
+            engine.prepare (sampleRate);
+            AnalysisEngine::Bands fftLevels {};
+            engine.pushSpectrum (input.data(), input.data(), numSamples, [&fftLevels] (const AnalysisEngine::Bands& levels) { fftLevels = levels; });
+
+            BandFilterbank filterbank;
+            filterbank.prepare (sampleRate, numBands);
+            filterbank.process (input.data(), input.data(), numSamples);
+            filterbank.getLevels (filterbankLevels.data());
+
+            // Levels are linear in dB over the display range.
+            const float fftDb = AnalysisEngine::spectrumFloorDb + fftLevels[(size_t) band] * displayRangeDb;
+            const float filterbankDb = AnalysisEngine::spectrumFloorDb + filterbankLevels[(size_t) band] * displayRangeDb;
+            const bool passed = std::abs (filterbankDb - fftDb) <= toleranceDb;
+            failures += passed ? 0 : 1;
+
+            std::printf ("  %-6d %10.0f %10.2f %10.2f %10s\n", band, centre, fftDb, filterbankDb, passed ? "ok" : "FAIL");
+        }
+
+        std::printf ("%d failure(s)\n", failures);
+        return failures;
+    }
+
+    // The FFT engine that feeds the band display against the filterbank at
+    // several band counts, on the same stereo noise. The FFT's cost does not
+    // depend on the band count; the filterbank's grows with it.
+    void runBandAnalysisBenchmark (double sampleRate, double seconds)
+    {
+        constexpr int blockSize = 512;
+        juce::AudioBuffer<float> noise (2, blockSize);
+        juce::Random random (0x5eed);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                noise.setSample (ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+        const auto numBlocks = juce::jmax (1, static_cast<int> (seconds * sampleRate / blockSize));
+        const auto nsPerSample = [&] (Clock::time_point start)
+        {
+            return 1.0e6 * millisecondsSince (start) / ((double) numBlocks * blockSize);
+        };
+        const auto realTime = [sampleRate] (double ns) { return 1.0e9 / (juce::jmax (1.0e-3, ns) * sampleRate); };
+
+        std::printf ("band analysis: %.0f Hz, %d samples per block\n", sampleRate, blockSize);
+        std::printf ("  %-18s %12s %12s %14s\n", "analysis", "ns/sample", "x realtime", "response ms");
+
+        {
+            AnalysisEngine engine;
+            engine.prepare (sampleRate);
+            int frames = 0;
+            const auto start = Clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+                engine.pushSpectrum (noise.getReadPointer (0), noise.getReadPointer (1), blockSize,
+                                     [&frames] (const AnalysisEngine::Bands&) { ++frames; });
+
+            const double ns = nsPerSample (start);
+
+            // A frame every fftSize samples; a transient waits up to that long.
+            std::printf ("  %-18s %12.3f %12.0f %14.2f  (%d frames)\n", "FFT, 16 bands", ns, realTime (ns),
+                         1000.0 * AnalysisEngine::fftSize / sampleRate, frames);
+        }
+
+        for (const int numBands : { 16, 31, 64 })
+        {
+            BandFilterbank filterbank;
+            filterbank.prepare (sampleRate, numBands);
+            const auto start = Clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+                filterbank.process (noise.getReadPointer (0), noise.getReadPointer (1), blockSize);
+
+            const double ns = nsPerSample (start);
+            const auto name = juce::String ("Filterbank, ") + juce::String (numBands) + " bands";
+
+            std::printf ("  %-18s %12.3f %12.0f %14.2f\n", name.toRawUTF8(), ns, realTime (ns),
+                         1000.0 * filterbankResponseSamples (sampleRate, numBands) / sampleRate);
+        }
+    }
+
+    // ─── Paint ──────────────────────────────────────────────────────────────
+
+    enum class PaintMode
+    {
+        uncached,   // whole editor, chrome redrawn every frame
+        cached,     // whole editor over the cached chrome
+        dirty,      // only what the tick invalidated, over the cached chrome
+        raster      // as dirty, with meters and correlation in raster layers
+    };
+
+    // Modes before raster draw the meters and correlation through Graphics.
+
+    // Paints the editor headlessly into a software image, once per timer tick,
+    // with 1/60 s of noise and a sine sweep processed between ticks. Only the
+    // paint is timed. Child components that repaint themselves are outside the
+    // dirty area and not counted in that mode.
+    void runPaintBenchmark (double sampleRate, int numFrames)
+    {
+        std::printf ("paint: %d frames, %.0f Hz\n", numFrames, sampleRate);
+        std::printf ("  %-8s %-10s %12s %12s %12s\n", "scale", "mode", "mean us", "p99 us", "area %");
+
+        const int samplesPerFrame = juce::roundToInt (sampleRate / 60.0);
+        constexpr int warmUpFrames = 30;
+
+        for (const float scale : { 1.0f, 2.0f })
+        {
+            for (const auto mode : { PaintMode::uncached, PaintMode::cached, PaintMode::dirty, PaintMode::raster })
+            {
+                NeonScopeAudioProcessor processor;
+                prepare (processor, sampleRate, samplesPerFrame);
+
+                std::unique_ptr<juce::AudioProcessorEditor> base (processor.createEditor());
+                auto* editor = dynamic_cast<NeonScopeAudioProcessorEditor*> (base.get());
+
+                if (editor == nullptr)
+                    return;
+
+                const bool dirtyOnly = mode == PaintMode::dirty || mode == PaintMode::raster;
+                editor->setBackgroundCacheEnabled (mode != PaintMode::uncached);
+                editor->setRasterLayersEnabled (mode == PaintMode::raster);
+
+                juce::Image image (juce::Image::RGB, juce::roundToInt ((float) editor->getWidth() * scale),
+                                   juce::roundToInt ((float) editor->getHeight() * scale), true, juce::SoftwareImageType());
+                juce::AudioBuffer<float> buffer (2, samplesPerFrame);
+                juce::MidiBuffer midi;
+                juce::Random random (0x5eed);
+                double phase = 0.0;
+
+                std::vector<double> frameMicroseconds;
+                frameMicroseconds.reserve ((size_t) numFrames);
+                double paintedArea = 0.0;
+
+                for (int frame = 0; frame < warmUpFrames + numFrames; ++frame)
+                {
+                    const double frequency = 40.0 * std::pow (500.0, (double) (frame % 600) / 600.0);
+
+                    for (int i = 0; i < samplesPerFrame; ++i)
+                    {
+                        phase += juce::MathConstants<double>::twoPi * frequency / sampleRate;
+                        const auto tone = 0.3f * (float) std::sin (phase);
+                        buffer.setSample (0, i, tone + (random.nextFloat() - 0.5f) * 0.1f);
+                        buffer.setSample (1, i, tone + (random.nextFloat() - 0.5f) * 0.1f);
+                    }
+
+                    processor.processBlock (buffer, midi);
+                    editor->tickForBenchmark();
+                    const auto invalidated = editor->takeInvalidatedArea();
+
+                    const auto start = Clock::now();
+                    {
+                        juce::Graphics g (image);
+                        g.addTransform (juce::AffineTransform::scale (scale));
+
+                        if (dirtyOnly)
+                            g.reduceClipRegion (invalidated);
+
+                        if (! dirtyOnly || ! invalidated.isEmpty())
+                            editor->paintEntireComponent (g, true);
+                    }
+                    const double microseconds = 1000.0 * millisecondsSince (start);
+
+                    if (frame < warmUpFrames)
+                        continue;
+
+                    frameMicroseconds.push_back (microseconds);
+
+                    double area = 0.0;
+                    for (const auto& r : invalidated)
+                        area += (double) r.getWidth() * r.getHeight();
+
+                    paintedArea += dirtyOnly ? area / ((double) editor->getWidth() * editor->getHeight()) : 1.0;
+                }
+
+                double mean = 0.0;
+                for (auto microseconds : frameMicroseconds)
+                    mean += microseconds;
+                mean /= (double) juce::jmax ((size_t) 1, frameMicroseconds.size());
+
+                std::sort (frameMicroseconds.begin(), frameMicroseconds.end());
+                const double p99 = frameMicroseconds.empty() ? 0.0
+                                 : frameMicroseconds[juce::jmin (frameMicroseconds.size() - 1, (size_t) ((double) frameMicroseconds.size() * 0.99))];
+
+                const char* modeName = mode == PaintMode::uncached ? "uncached"
+                                     : mode == PaintMode::cached   ? "cached"
+                                     : mode == PaintMode::dirty    ? "dirty"
+                                                                   : "raster";
+                std::printf ("  %-8s %-10s %12.1f %12.1f %12.1f\n", (juce::String (scale, 0) + "x").toRawUTF8(), modeName,
+                             mean, p99, 100.0 * paintedArea / juce::jmax (1, numFrames));
+            }
+        }
+    }
+
+    juce::Array<int> parseIntList (const juce::String& text)
+    {
+        juce::Array<int> values;
+
+        for (const auto& token : juce::StringArray::fromTokens (text, ",", {}))
+            if (token.trim().getIntValue() > 0)
+                values.add (token.trim().getIntValue());
+
+        return values;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList args (argc, argv);
+
+    const auto intOption = [&args] (const char* option, int defaultValue)
+    {
+        return args.containsOption (option) ? args.getValueForOption (option).getIntValue() : defaultValue;
+    };
+
+    const auto stringOption = [&args] (const char* option, const juce::String& defaultValue)
+    {
+        return args.containsOption (option) ? args.getValueForOption (option) : defaultValue;
+    };
+
+    const auto suite = stringOption ("--suite", "stages");
+    const int sampleRate = juce::jmax (8000, intOption ("--rate", 48000));
+
+    if (suite == "startup" || suite == "all")
+    {
+        const int numInstances = juce::jmax (1, intOption ("--instances", 200));
+        const int mode = juce::jlimit (0, 3, intOption ("--mode", 0));
+        const int blockSize = juce::jmax (1, intOption ("--block", 512));
+
+        runStartupBenchmark (numInstances, mode, static_cast<double> (sampleRate), blockSize);
+    }
+
+    if (suite == "loudness" || suite == "all")
+    {
+        const double seconds = juce::jmax (0.1, stringOption ("--seconds", "5").getDoubleValue());
+
+        const int failures = runLoudnessConformance (static_cast<double> (sampleRate), seconds)
+                           + runTruePeakChecks (static_cast<double> (sampleRate), seconds);
+
+        if (failures > 0)
+            return 1;
+    }
+
+    if (suite == "bands" || suite == "all")
+    {
+        if (runBandLevelChecks (static_cast<double> (sampleRate)) > 0)
+            return 1;
+
+        runBandAnalysisBenchmark (static_cast<double> (sampleRate), juce::jmax (0.1, stringOption ("--seconds", "5").getDoubleValue()));
+    }
+
+    if (suite == "paint" || suite == "all")
+        runPaintBenchmark (static_cast<double> (sampleRate), juce::jmax (1, intOption ("--frames", 600)));
+
+    if (suite != "stages" && suite != "all")
+        return 0;
+
+    auto blockSizes = parseIntList (stringOption ("--block-sizes", "64,512,2048"));
+    auto channelCounts = parseIntList (stringOption ("--channels", "1,2"));
+    channelCounts.removeIf ([] (int channels) { return channels > 2; });
+
+    if (blockSizes.isEmpty() || channelCounts.isEmpty())
+    {
+        std::fprintf (stderr, "--block-sizes and --channels need at least one value (channels: 1 or 2)\n");
+        return 2;
+    }
+
+    const double seconds = juce::jmax (0.1, stringOption ("--seconds", "5").getDoubleValue());
+    int failures = 0;
+    const auto results = runStageBenchmarks (blockSizes, channelCounts, static_cast<double> (sampleRate), seconds, failures);
+
+    if (failures > 0)
+    {
+        std::fprintf (stderr, "%d stage case(s) could not be run\n", failures);
+        return 1;
+    }
+
+    if (args.containsOption ("--json"))
+    {
+        const juce::File jsonFile (juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--json")));
+
+        if (! jsonFile.replaceWithText (juce::JSON::toString (resultsToJson (results, sampleRate))))
+        {
+            std::fprintf (stderr, "could not write %s\n", jsonFile.getFullPathName().toRawUTF8());
+            return 2;
+        }
+    }
+
+    if (args.containsOption ("--baseline"))
+    {
+        const juce::File baselineFile (juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--baseline")));
+        const auto baseline = juce::JSON::parse (baselineFile);
+
+        if (! baseline.isObject())
+        {
+            std::fprintf (stderr, "could not read baseline %s\n", baselineFile.getFullPathName().toRawUTF8());
+            return 2;
+        }
+
+        const double threshold = juce::jmax (0.0, stringOption ("--threshold", "10").getDoubleValue());
+        return compareWithBaseline (results, baseline, threshold) > 0 ? 1 : 0;
+    }
+
+    return 0;
+}
@@ -0,0 +1,321 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A headless stand-in for a DAW session: N instances as track inserts, with
+// every track processed once per host cycle by a pool of worker threads that
+// pull tracks off a shared counter, the way most hosts schedule a flat graph.
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double microsecondsBetween (Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::micro> (end - start).count();
+    }
+
+    // Resident set size in bytes, or 0 where /proc is unavailable.
+    size_t getResidentBytes()
+    {
+       #if JUCE_LINUX
+        std::ifstream status ("/proc/self/status");
+        std::string line;
+
+        while (std::getline (status, line))
+            if (line.rfind ("VmRSS:", 0) == 0)
+                return static_cast<size_t> (std::stoull (line.substr (6))) * 1024;
+       #endif
+
+        return 0;
+    }
+
+    struct Track
+    {
+        std::unique_ptr<NeonScopeAudioProcessor> processor;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+
+        // Written by whichever worker ran the track this cycle; the cycle
+        // hand-off orders those writes before the main thread reads them.
+        double totalMicroseconds = 0.0;
+        double worstMicroseconds = 0.0;
+    };
+
+    class SessionGraph
+    {
+    public:
+        SessionGraph (std::vector<Track>& tracksToRun, const juce::AudioBuffer<float>& sourceSignal, int numThreads)
+            : tracks (tracksToRun), source (sourceSignal)
+        {
+            for (int i = 1; i < numThreads; ++i)
+            {
+                workers.push_back (std::make_unique<Worker> (*this, i));
+                workers.back()->startThread();
+            }
+        }
+
+        ~SessionGraph()
+        {
+            for (auto& worker : workers)
+                worker->signalThreadShouldExit();
+
+            for (auto& worker : workers)
+            {
+                worker->start.signal();
+                worker->stopThread (2000);
+            }
+        }
+
+        // Runs every track once and returns the wall time of the cycle.
+        double runCycle()
+        {
+            const auto cycleStart = Clock::now();
+
+            nextTrack.store (0, std::memory_order_relaxed);
+            pendingWorkers.store (static_cast<int> (workers.size()), std::memory_order_release);
+
+            for (auto& worker : workers)
+                worker->start.signal();
+
+            processTracks();
+
+            if (! workers.empty())
+                cycleDone.wait();
+
+            return microsecondsBetween (cycleStart, Clock::now());
+        }
+
+    private:
+        struct Worker : public juce::Thread
+        {
+            Worker (SessionGraph& g, int index)
+                : juce::Thread ("Session worker " + juce::String (index)), graph (g) {}
+
+            void run() override
+            {
+                for (;;)
+                {
+                    start.wait();
+
+                    if (threadShouldExit())
+                        return;
+
+                    graph.processTracks();
+
+                    if (graph.pendingWorkers.fetch_sub (1, std::memory_order_acq_rel) == 1)
+                        graph.cycleDone.signal();
+                }
+            }
+
+            SessionGraph& graph;
+            juce::WaitableEvent start;
+        };
+
+        void processTracks()
+        {
+            const int numTracks = static_cast<int> (tracks.size());
+
+            for (int index = nextTrack.fetch_add (1, std::memory_order_relaxed); index < numTracks;
+                 index = nextTrack.fetch_add (1, std::memory_order_relaxed))
+            {
+                auto& track = tracks[(size_t) index];
+
+                // The upstream signal a host would hand the insert.
+                for (int ch = 0; ch < track.buffer.getNumChannels(); ++ch)
+                    track.buffer.copyFrom (ch, 0, source, ch % source.getNumChannels(), 0, track.buffer.getNumSamples());
+
+                const auto blockStart = Clock::now();
+                track.processor->processBlock (track.buffer, track.midi);
+                const auto elapsed = microsecondsBetween (blockStart, Clock::now());
+
+                track.totalMicroseconds += elapsed;
+                track.worstMicroseconds = juce::jmax (track.worstMicroseconds, elapsed);
+            }
+        }
+
+        std::vector<Track>& tracks;
+        const juce::AudioBuffer<float>& source;
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<int> nextTrack { 0 };
+        std::atomic<int> pendingWorkers { 0 };
+        juce::WaitableEvent cycleDone;
+    };
+
+    struct SessionResult
+    {
+        int instances = 0;
+        int threads = 0;
+        double cpuPercent = 0.0;
+        double meanCyclePercent = 0.0;
+        double worstCyclePercent = 0.0;
+        double worstInstanceMicroseconds = 0.0;
+        double nsPerInstanceSample = 0.0;
+        size_t footprintBytes = 0;
+        size_t residentBytes = 0;
+    };
+
+    // Every parameter gets a random normalised value, so a session mixes
+    // modes, saturators and oversampling factors the way real projects do.
+    void randomiseParameters (NeonScopeAudioProcessor& processor, juce::Random& random)
+    {
+        for (auto* parameter : processor.getParameters())
+            parameter->setValueNotifyingHost (random.nextFloat());
+    }
+
+    SessionResult runSession (int numInstances, int numThreads, double sampleRate, int blockSize,
+                              double seconds, juce::int64 seed)
+    {
+        juce::Random random (seed);
+        const auto residentBefore = getResidentBytes();
+
+        std::vector<Track> tracks ((size_t) numInstances);
+
+        for (auto& track : tracks)
+        {
+            track.processor = std::make_unique<NeonScopeAudioProcessor>();
+            randomiseParameters (*track.processor, random);
+            track.processor->setRateAndBufferSizeDetails (sampleRate, blockSize);
+            track.processor->prepareToPlay (sampleRate, blockSize);
+            track.buffer.setSize (2, blockSize);
+        }
+
+        juce::AudioBuffer<float> source (2, blockSize);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                source.setSample (ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+        SessionGraph graph (tracks, source, numThreads);
+
+        // Warm-up cycles are not counted.
+        for (int cycle = 0; cycle < 32; ++cycle)
+            graph.runCycle();
+
+        for (auto& track : tracks)
+            track.totalMicroseconds = track.worstMicroseconds = 0.0;
+
+        const int numCycles = juce::jmax (1, static_cast<int> (seconds * sampleRate / blockSize));
+        const double budgetMicroseconds = 1.0e6 * blockSize / sampleRate;
+        double cycleSum = 0.0;
+        double worstCycle = 0.0;
+
+        for (int cycle = 0; cycle < numCycles; ++cycle)
+        {
+            const auto cycleMicroseconds = graph.runCycle();
+            cycleSum += cycleMicroseconds;
+            worstCycle = juce::jmax (worstCycle, cycleMicroseconds);
+        }
+
+        SessionResult result;
+        result.instances = numInstances;
+        result.threads = numThreads;
+
+        double processingMicroseconds = 0.0;
+
+        for (const auto& track : tracks)
+        {
+            processingMicroseconds += track.totalMicroseconds;
+            result.worstInstanceMicroseconds = juce::jmax (result.worstInstanceMicroseconds, track.worstMicroseconds);
+            result.footprintBytes += track.processor->getMemoryFootprint().total();
+        }
+
+        const double audioMicroseconds = numCycles * budgetMicroseconds;
+        result.cpuPercent = 100.0 * processingMicroseconds / audioMicroseconds;
+        result.meanCyclePercent = 100.0 * cycleSum / numCycles / budgetMicroseconds;
+        result.worstCyclePercent = 100.0 * worstCycle / budgetMicroseconds;
+        result.nsPerInstanceSample = 1000.0 * processingMicroseconds / ((double) numCycles * blockSize * numInstances);
+
+        const auto residentAfter = getResidentBytes();
+        result.residentBytes = residentAfter > residentBefore ? residentAfter - residentBefore : 0;
+        return result;
+    }
+
+    juce::var resultsToJson (const std::vector<SessionResult>& results, double sampleRate, int blockSize)
+    {
+        juce::Array<juce::var> entries;
+
+        for (const auto& result : results)
+        {
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty ("instances", result.instances);
+            entry->setProperty ("threads", result.threads);
+            entry->setProperty ("cpuPercent", result.cpuPercent);
+            entry->setProperty ("meanCyclePercent", result.meanCyclePercent);
+            entry->setProperty ("worstCyclePercent", result.worstCyclePercent);
+            entry->setProperty ("worstInstanceMicroseconds", result.worstInstanceMicroseconds);
+            entry->setProperty ("nsPerInstanceSample", result.nsPerInstanceSample);
+            entry->setProperty ("footprintBytes", (juce::int64) result.footprintBytes);
+            entry->setProperty ("residentBytes", (juce::int64) result.residentBytes);
+            entries.add (juce::var (entry));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty ("sampleRate", sampleRate);
+        root->setProperty ("blockSize", blockSize);
+        root->setProperty ("results", entries);
+        return juce::var (root);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList args (argc, argv);
+
+    const auto intOption = [&args] (const char* option, int defaultValue)
+    {
+        return args.containsOption (option) ? args.getValueForOption (option).getIntValue() : defaultValue;
+    };
+
+    const auto stringOption = [&args] (const char* option, const juce::String& defaultValue)
+    {
+        return args.containsOption (option) ? args.getValueForOption (option) : defaultValue;
+    };
+
+    juce::Array<int> instanceCounts;
+    for (const auto& token : juce::StringArray::fromTokens (stringOption ("--instances", "25,50,100,150,200,300"), ",", {}))
+        if (token.trim().getIntValue() > 0)
+            instanceCounts.add (token.trim().getIntValue());
+
+    const int numThreads = juce::jlimit (1, 256, intOption ("--threads", juce::SystemStats::getNumCpus()));
+    const int sampleRate = juce::jmax (8000, intOption ("--rate", 48000));
+    const int blockSize = juce::jlimit (16, 8192, intOption ("--block", 256));
+    const double seconds = juce::jmax (0.1, stringOption ("--seconds", "5").getDoubleValue());
+    const int seed = intOption ("--seed", 1);
+
+    std::printf ("session: %d threads, %d Hz, %d samples, %.1f s per run\n", numThreads, sampleRate, blockSize, seconds);
+    std::printf ("  %9s %10s %12s %12s %14s %14s %12s %12s\n", "instances", "cpu %", "cycle avg %", "cycle max %",
+                 "worst inst us", "ns/inst-smpl", "footprint MB", "rss MB");
+
+    std::vector<SessionResult> results;
+
+    for (const auto numInstances : instanceCounts)
+    {
+        const auto result = runSession (numInstances, numThreads, static_cast<double> (sampleRate), blockSize, seconds, seed);
+        results.push_back (result);
+
+        std::printf ("  %9d %10.1f %12.1f %12.1f %14.1f %14.2f %12.2f %12.2f\n", result.instances, result.cpuPercent,
+                     result.meanCyclePercent, result.worstCyclePercent, result.worstInstanceMicroseconds,
+                     result.nsPerInstanceSample, result.footprintBytes / 1048576.0, result.residentBytes / 1048576.0);
+    }
+
+    if (args.containsOption ("--json"))
+    {
+        const juce::File jsonFile (juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--json")));
+
+        if (! jsonFile.replaceWithText (juce::JSON::toString (resultsToJson (results, sampleRate, blockSize))))
+        {
+            std::fprintf (stderr, "could not write %s\n", jsonFile.getFullPathName().toRawUTF8());
+            return 2;
+        }
+    }
+
+    return 0;
+}
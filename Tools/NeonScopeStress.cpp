@@ -0,0 +1,316 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <vector>
+
+// Heap allocations made by the thread driving processBlock are counted while
+// a block is running; the background preparer is free to allocate.
+namespace
+{
+    thread_local bool countingAllocations = false;
+    thread_local long allocationsInBlocks = 0;
+}
+
+void* operator new (std::size_t size)
+{
+    if (countingAllocations)
+        ++allocationsInBlocks;
+
+    if (auto* memory = std::malloc (size > 0 ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void operator delete (void* memory) noexcept                { std::free (memory); }
+void operator delete (void* memory, std::size_t) noexcept   { std::free (memory); }
+
+namespace
+{
+    void setParameter (NeonScopeAudioProcessor& processor, const juce::String& paramID, float value)
+    {
+        if (auto* parameter = processor.getValueTreeState().getParameter (paramID))
+            parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    struct BlockSizeStressResult
+    {
+        long blocks = 0;
+        long samples = 0;
+        long allocations = 0;
+        long badSamples = 0;
+    };
+
+    // Random host block sizes from 1 to maxBlockSize against a processor that
+    // was prepared for preparedBlockSize, switching mode and oversampling now
+    // and then so every chain configuration sees odd sizes.
+    BlockSizeStressResult runBlockSizeStress (int numBlocks, int preparedBlockSize, int maxBlockSize, juce::int64 seed)
+    {
+        constexpr double sampleRate = 48000.0;
+        juce::Random random (seed);
+
+        NeonScopeAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails (sampleRate, preparedBlockSize);
+        processor.prepareToPlay (sampleRate, preparedBlockSize);
+
+        juce::AudioBuffer<float> buffer (2, maxBlockSize);
+        juce::MidiBuffer midi;
+        BlockSizeStressResult result;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            if (random.nextInt (64) == 0)
+            {
+                setParameter (processor, "mode", static_cast<float> (random.nextInt (4)));
+                setParameter (processor, "oversampling", static_cast<float> (random.nextInt (5)));
+                setParameter (processor, "satMode", static_cast<float> (random.nextInt (6)));
+                setParameter (processor, "bandListen", random.nextBool() ? 1.0f : 0.0f);
+            }
+
+            const int numSamples = 1 + random.nextInt (maxBlockSize);
+            buffer.setSize (2, numSamples, false, false, true);
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                auto* data = buffer.getWritePointer (ch);
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = random.nextFloat() * 2.0f - 1.0f;
+            }
+
+            countingAllocations = true;
+            processor.processBlock (buffer, midi);
+            countingAllocations = false;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                const auto* data = buffer.getReadPointer (ch);
+                for (int i = 0; i < numSamples; ++i)
+                    if (! std::isfinite (data[i]) || std::abs (data[i]) > 1.0f)
+                        ++result.badSamples;
+            }
+
+            ++result.blocks;
+            result.samples += numSamples;
+        }
+
+        result.allocations = allocationsInBlocks;
+        allocationsInBlocks = 0;
+        return result;
+    }
+
+    // ─── Latency stress ─────────────────────────────────────────────────────
+
+    enum class StressSignal
+    {
+        noise,
+        dc,
+        denormals,
+        nonFinite
+    };
+
+    const char* getSignalName (StressSignal signal)
+    {
+        switch (signal)
+        {
+            case StressSignal::dc:         return "full-scale DC";
+            case StressSignal::denormals:  return "denormals";
+            case StressSignal::nonFinite:  return "NaN/Inf";
+            case StressSignal::noise:
+            default:                       return "full-scale noise";
+        }
+    }
+
+    void fillSignal (juce::AudioBuffer<float>& buffer, int numSamples, StressSignal signal, juce::Random& random)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer (ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                switch (signal)
+                {
+                    case StressSignal::dc:         data[i] = 1.0f; break;
+                    case StressSignal::denormals:  data[i] = (random.nextFloat() * 2.0f - 1.0f) * 1.0e-39f; break;
+                    case StressSignal::noise:
+                    case StressSignal::nonFinite:
+                    default:                       data[i] = random.nextFloat() * 2.0f - 1.0f; break;
+                }
+            }
+
+            if (signal == StressSignal::nonFinite)
+            {
+                data[random.nextInt (numSamples)] = std::numeric_limits<float>::quiet_NaN();
+                data[random.nextInt (numSamples)] = std::numeric_limits<float>::infinity();
+                data[random.nextInt (numSamples)] = -std::numeric_limits<float>::infinity();
+            }
+        }
+    }
+
+    struct SlowBlock
+    {
+        double budgetFraction = 0.0;
+        double microseconds = 0.0;
+        int numSamples = 0;
+        int mode = 0;
+        int oversampling = 0;
+        int satMode = 0;
+    };
+
+    struct LatencyStressResult
+    {
+        std::vector<double> blockMicroseconds;
+        std::vector<SlowBlock> overruns;
+        long allocations = 0;
+        long badSamples = 0;
+
+        double percentile (double fraction) const
+        {
+            if (blockMicroseconds.empty())
+                return 0.0;
+
+            const auto rank = static_cast<size_t> (std::ceil (fraction * static_cast<double> (blockMicroseconds.size()))) - 1;
+            return blockMicroseconds[juce::jmin (rank, blockMicroseconds.size() - 1)];
+        }
+    };
+
+    // Every block gets a random size and a random value for every parameter,
+    // so mode, saturator and oversampling switches land mid-stream and the
+    // chain fallbacks are exercised along with the steady state.
+    LatencyStressResult runLatencyStress (StressSignal signal, int numBlocks, int preparedBlockSize, int maxBlockSize,
+                                          double sampleRate, double budgetFraction, juce::int64 seed)
+    {
+        using Clock = std::chrono::steady_clock;
+        juce::Random random (seed);
+
+        NeonScopeAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails (sampleRate, preparedBlockSize);
+        processor.prepareToPlay (sampleRate, preparedBlockSize);
+
+        auto& state = processor.getValueTreeState();
+        const auto& parameters = processor.getParameters();
+        const auto choiceOf = [&state] (const char* paramID)
+        {
+            return juce::roundToInt (state.getRawParameterValue (paramID)->load());
+        };
+
+        juce::AudioBuffer<float> buffer (2, maxBlockSize);
+        juce::MidiBuffer midi;
+        LatencyStressResult result;
+        result.blockMicroseconds.reserve ((size_t) numBlocks);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (auto* parameter : parameters)
+                if (random.nextInt (4) == 0)
+                    parameter->setValueNotifyingHost (random.nextFloat());
+
+            const int numSamples = 1 + random.nextInt (maxBlockSize);
+            buffer.setSize (2, numSamples, false, false, true);
+            fillSignal (buffer, numSamples, signal, random);
+
+            countingAllocations = true;
+            const auto start = Clock::now();
+            processor.processBlock (buffer, midi);
+            const auto microseconds = std::chrono::duration<double, std::micro> (Clock::now() - start).count();
+            countingAllocations = false;
+
+            result.blockMicroseconds.push_back (microseconds);
+
+            const double fraction = microseconds / (1.0e6 * numSamples / sampleRate);
+
+            if (fraction > budgetFraction)
+                result.overruns.push_back ({ fraction, microseconds, numSamples,
+                                             choiceOf ("mode"), choiceOf ("oversampling"), choiceOf ("satMode") });
+
+            // NaN and Inf input may legitimately come out the other side.
+            if (signal == StressSignal::nonFinite)
+                continue;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                const auto* data = buffer.getReadPointer (ch);
+                for (int i = 0; i < numSamples; ++i)
+                    if (! std::isfinite (data[i]) || std::abs (data[i]) > 1.0f)
+                        ++result.badSamples;
+            }
+        }
+
+        std::sort (result.blockMicroseconds.begin(), result.blockMicroseconds.end());
+        std::sort (result.overruns.begin(), result.overruns.end(),
+                   [] (const SlowBlock& a, const SlowBlock& b) { return a.budgetFraction > b.budgetFraction; });
+
+        result.allocations = allocationsInBlocks;
+        allocationsInBlocks = 0;
+        return result;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList args (argc, argv);
+
+    const auto intOption = [&args] (const char* option, int defaultValue)
+    {
+        return args.containsOption (option) ? args.getValueForOption (option).getIntValue() : defaultValue;
+    };
+
+    const int numBlocks = juce::jmax (1, intOption ("--blocks", 20000));
+    const int maxBlockSize = juce::jlimit (1, 65536, intOption ("--max-block", 8192));
+    const int seed = intOption ("--seed", 1);
+    const int latencyBlocks = juce::jmax (1, intOption ("--latency-blocks", 20000));
+    const double sampleRate = static_cast<double> (juce::jmax (8000, intOption ("--rate", 48000)));
+    const double budgetFraction = args.containsOption ("--budget-fraction")
+                                    ? juce::jmax (0.01, args.getValueForOption ("--budget-fraction").getDoubleValue())
+                                    : 0.5;
+
+    bool passed = true;
+
+    for (const int preparedBlockSize : { 32, 512, 4096 })
+    {
+        const auto result = runBlockSizeStress (numBlocks, preparedBlockSize, maxBlockSize, seed);
+        const bool ok = result.allocations == 0 && result.badSamples == 0;
+        passed = passed && ok;
+
+        std::printf ("block sizes 1-%d, prepared for %d: %ld blocks, %ld samples, %ld allocations, %ld bad samples %s\n",
+                     maxBlockSize, preparedBlockSize, result.blocks, result.samples,
+                     result.allocations, result.badSamples, ok ? "OK" : "FAILED");
+    }
+
+    std::printf ("latency: %d blocks per signal, sizes 1-%d, prepared for 512, every parameter automated, "
+                 "flagging blocks over %.0f%% of budget\n", latencyBlocks, maxBlockSize, 100.0 * budgetFraction);
+    std::printf ("  %-18s %10s %10s %10s %10s %9s %7s\n", "signal", "p50 us", "p99 us", "p99.9 us", "max us", "overruns", "allocs");
+
+    for (const auto signal : { StressSignal::noise, StressSignal::dc, StressSignal::denormals, StressSignal::nonFinite })
+    {
+        const auto result = runLatencyStress (signal, latencyBlocks, 512, maxBlockSize, sampleRate, budgetFraction, seed);
+        const bool ok = result.allocations == 0 && result.badSamples == 0 && result.overruns.empty();
+        passed = passed && ok;
+
+        std::printf ("  %-18s %10.2f %10.2f %10.2f %10.2f %9zu %7ld %s\n", getSignalName (signal),
+                     result.percentile (0.5), result.percentile (0.99), result.percentile (0.999),
+                     result.blockMicroseconds.empty() ? 0.0 : result.blockMicroseconds.back(),
+                     result.overruns.size(), result.allocations, ok ? "OK" : "FAILED");
+
+        if (result.badSamples > 0)
+            std::printf ("    %ld non-finite or out-of-range output samples\n", result.badSamples);
+
+        for (size_t i = 0; i < juce::jmin<size_t> (5, result.overruns.size()); ++i)
+        {
+            const auto& slow = result.overruns[i];
+            std::printf ("    %.2f us for %d samples (%.0f%% of budget): mode %d, oversampling %d, satMode %d\n",
+                         slow.microseconds, slow.numSamples, 100.0 * slow.budgetFraction,
+                         slow.mode, slow.oversampling, slow.satMode);
+        }
+    }
+
+    return passed ? 0 : 1;
+}